@@ -0,0 +1,74 @@
+/*
+ * Dispatch microbenchmark for the NVDA-Arma 3 Bridge DLL
+ *
+ * Loads a bridge DLL and times RVExtension for each command with a typical
+ * payload, printing ns/call. Run it against two builds (e.g. before and after
+ * a change) to compare. Speech commands that reach NVDA are not exercised, and
+ * audio commands run without aim_start/radar_start so no device is opened.
+ *
+ * Build with Visual Studio 2022 Developer Command Prompt:
+ *   cl /EHsc /O2 /std:c++17 bench_dispatch.cpp
+ *
+ * Usage:
+ *   bench_dispatch.exe [path\to\nvda_arma3_bridge_x64.dll] [iterations]
+ */
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+typedef void (__stdcall *RVExtensionFunc)(char *output, int outputSize, const char *function);
+
+// Representative payloads, formatted the way SQF's format/str produce them
+static const char* BENCH_COMMANDS[] = {
+    "aim_update:-0.123456,612.5,0.0834,0.0213,0.0185,0.0042",
+    "aim_update:0,-1,0",
+    "aim_blip",
+    "aim_horiz_on",
+    "radar_beep:0.377778,12.8431,grass",
+    "radar_beep:-1,50,none",
+    "beacon_update:-0.0712",
+    "speech_stats",
+    "no_such_command",
+};
+
+int main(int argc, char** argv) {
+    const char* dllPath = (argc > 1) ? argv[1] : "nvda_arma3_bridge_x64.dll";
+    int iterations = (argc > 2) ? atoi(argv[2]) : 1000000;
+    if (iterations <= 0) iterations = 1000000;
+
+    HMODULE dll = LoadLibraryA(dllPath);
+    if (!dll) {
+        printf("ERROR: could not load %s\n", dllPath);
+        return 1;
+    }
+
+    RVExtensionFunc rvExtension = (RVExtensionFunc)GetProcAddress(dll, "RVExtension");
+    if (!rvExtension) {
+        printf("ERROR: RVExtension not exported by %s\n", dllPath);
+        return 1;
+    }
+
+    static char output[10240];
+    printf("%s, %d iterations per command\n\n", dllPath, iterations);
+
+    for (const char* cmd : BENCH_COMMANDS) {
+        // Warm up caches and any lazy initialization
+        for (int i = 0; i < 10000; i++) {
+            rvExtension(output, sizeof(output), cmd);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            rvExtension(output, sizeof(output), cmd);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double nsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        printf("%-58s %8.1f ns/call  -> %s\n", cmd, nsPerCall, output);
+    }
+
+    // Process exit unloads the DLL (its DllMain handles shutdown)
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Radar material classification benchmark for the NVDA-Arma 3 Bridge DLL
+ *
+ * Loads a bridge DLL and resolves every surface name below through its material
+ * command (the classification radar_beep and radar_sweep_hit use), printing the
+ * material and ns/call per name. Names in the DLL's compiled-in table resolve by
+ * hash; the others go through the keyword rules once and then hit the LRU cache,
+ * so the first pass over them is timed separately. Includes the RVExtension call
+ * overhead; run bench_dispatch to see that on its own.
+ *
+ * Build with Visual Studio 2022 Developer Command Prompt:
+ *   cl /EHsc /O2 /std:c++17 bench_materials.cpp
+ *
+ * Usage:
+ *   bench_materials.exe [path\to\nvda_arma3_bridge_x64.dll] [iterations]
+ */
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+
+typedef void (__stdcall *RVExtensionFunc)(char *output, int outputSize, const char *function);
+
+// As SQF reports them: surfaceType for terrain, lineIntersectsSurfaces for objects
+// (with the "|kind" suffix fn_updateTerrainRadar adds for objects)
+static const char* TABLE_SURFACES[] = {
+    "#GdtRock", "#GdtStony", "#GdtConcrete", "#GdtAsphalt", "#GdtSoil", "#GdtDirt",
+    "#GdtGrassGreen", "#GdtGrassDry", "#GdtGrassWild", "#GdtWildField", "#GdtThorn",
+    "#GdtDead", "#GdtDesert", "#GdtMarsh", "#GdtBeach", "#GdtSeabed", "#GdtForestPine",
+    "#GdtVRsurface01",
+    "#GdtStratisConcrete", "#GdtStratisRocky", "#GdtStratisDryGrass", "#GdtStratisGreenGrass",
+    "#GdtStratisForestPine", "#GdtStratisThistles", "#GdtStratisDirt", "#GdtStratisBeach",
+    "#GdtStratisSeabed",
+    "#CRGrass1", "#CRGrass2", "#CRGrassW1", "#CRGrassW2", "#CRForest1", "#CRForest2",
+    "#CRHeather", "#CRDirt", "#CRTarmac", "#CRConcrete", "#CRBoulders", "#CRStony",
+    "a3\\data_f\\penetration\\concrete.bisurf|building",
+    "a3\\data_f\\penetration\\plaster.bisurf|building",
+    "a3\\data_f\\penetration\\building.bisurf|building",
+    "a3\\data_f\\penetration\\wood.bisurf|tree",
+    "a3\\data_f\\penetration\\wood_plank.bisurf",
+    "a3\\data_f\\penetration\\metal.bisurf|vehicle",
+    "a3\\data_f\\penetration\\metal_plate.bisurf|vehicle",
+    "a3\\data_f\\penetration\\armour.bisurf|vehicle",
+    "a3\\data_f\\penetration\\armour_plate.bisurf|vehicle",
+    "a3\\data_f\\penetration\\glass.bisurf|vehicle",
+    "a3\\data_f\\penetration\\glass_armored.bisurf|vehicle",
+    "a3\\data_f\\penetration\\tyre.bisurf|vehicle",
+    "a3\\data_f\\penetration\\plastic.bisurf",
+    "a3\\data_f\\penetration\\body.bisurf|man",
+    "grass", "concrete", "wood", "metal", "water", "man", "glass", "none",
+};
+
+// Not in the table (other terrains and mods): keyword rules, then the LRU cache
+static const char* RULE_SURFACES[] = {
+    "#GdtMud", "#GdtGravel", "#GdtForestFloor", "#GdtRockyGround", "#GdtSandDunes",
+    "#CUP_Asphalt", "#CUP_Concrete_Road", "#CUP_WoodFloor", "#CUP_SteelBridge",
+    "#MyMapWater", "#MyMapIronGrate", "#MyMapGlassRoof",
+    "a3\\data_f\\penetration\\rock_hard.bisurf",
+    "a3\\data_f\\penetration\\wood_solid.bisurf|tree",
+    "a3\\data_f\\penetration\\steel_thin.bisurf|vehicle",
+    "a3\\data_f\\penetration\\canvas.bisurf|vehicle",
+    "mymod\\data\\penetration\\fabric.bisurf|building",
+    "",
+};
+
+static const int TABLE_COUNT = (int)(sizeof(TABLE_SURFACES) / sizeof(TABLE_SURFACES[0]));
+static const int RULE_COUNT = (int)(sizeof(RULE_SURFACES) / sizeof(RULE_SURFACES[0]));
+
+// ns/call for one name over the given iterations; output holds its material
+static double time_name(RVExtensionFunc rvExtension, const std::string& command, int iterations,
+                        char* output, int outputSize) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        rvExtension(output, outputSize, command.c_str());
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    const char* dllPath = (argc > 1) ? argv[1] : "nvda_arma3_bridge_x64.dll";
+    int iterations = (argc > 2) ? atoi(argv[2]) : 1000000;
+    if (iterations <= 0) iterations = 1000000;
+
+    HMODULE dll = LoadLibraryA(dllPath);
+    if (!dll) {
+        printf("ERROR: could not load %s\n", dllPath);
+        return 1;
+    }
+
+    RVExtensionFunc rvExtension = (RVExtensionFunc)GetProcAddress(dll, "RVExtension");
+    if (!rvExtension) {
+        printf("ERROR: RVExtension not exported by %s\n", dllPath);
+        return 1;
+    }
+
+    static char output[10240];
+    printf("%s, %d iterations per name\n\n", dllPath, iterations);
+
+    // First pass over the rule names: every one is a cache miss
+    auto start = std::chrono::steady_clock::now();
+    for (const char* name : RULE_SURFACES) {
+        rvExtension(output, sizeof(output), (std::string("material:") + name).c_str());
+    }
+    auto end = std::chrono::steady_clock::now();
+    double firstPassNs = std::chrono::duration<double, std::nano>(end - start).count() / RULE_COUNT;
+
+    double tableTotal = 0.0;
+    double ruleTotal = 0.0;
+    for (int list = 0; list < 2; list++) {
+        const char** names = list ? RULE_SURFACES : TABLE_SURFACES;
+        int count = list ? RULE_COUNT : TABLE_COUNT;
+        printf(list ? "\nkeyword rules + LRU cache:\n" : "compiled-in table:\n");
+        for (int n = 0; n < count; n++) {
+            std::string command = std::string("material:") + names[n];
+            double nsPerCall = time_name(rvExtension, command, iterations, output, sizeof(output));
+            (list ? ruleTotal : tableTotal) += nsPerCall;
+            printf("  %-52s %8.1f ns/call  -> %s\n", names[n], nsPerCall, output);
+        }
+    }
+
+    rvExtension(output, sizeof(output), "radar_stats");
+    printf("\ntable: %.1f ns/call mean, rules cached: %.1f ns/call mean, rules first pass: %.1f ns/call\n",
+           tableTotal / TABLE_COUNT, ruleTotal / RULE_COUNT, firstPassNs);
+    printf("radar_stats: %s\n", output);
+
+    // Process exit unloads the DLL (its DllMain handles shutdown)
+    return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Synth benchmark for the NVDA-Arma 3 Bridge DLL
+ *
+ * Loads a bridge DLL and runs its synth_bench command: every voice type
+ * (aim, blip, radar, beacon) is rendered for the given number of seconds with
+ * each kernel table the CPU supports (scalar, SSE2, AVX2). Prints frames/sec
+ * per voice and ISA, and the largest difference between each SIMD output and
+ * the scalar one. Exits with 2 if they disagree beyond the tolerance.
+ * No audio device is opened.
+ *
+ * synth_bench is only compiled into bench builds of the bridge (BRIDGE_BENCH), since
+ * it blocks the calling thread. Build one next to the shipped DLL and this program
+ * with Visual Studio 2022 Developer Command Prompt:
+ *   cl /LD /EHsc /O2 /std:c++17 /DBRIDGE_BENCH /Fe:nvda_arma3_bridge_bench_x64.dll nvda_arma3_bridge.cpp nvdaControllerClient.lib
+ *   cl /EHsc /O2 /std:c++17 bench_synth.cpp
+ *
+ * Usage:
+ *   bench_synth.exe [path\to\nvda_arma3_bridge_bench_x64.dll] [seconds]
+ */
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+typedef void (__stdcall *RVExtensionFunc)(char *output, int outputSize, const char *function);
+
+int main(int argc, char** argv) {
+    const char* dllPath = (argc > 1) ? argv[1] : "nvda_arma3_bridge_bench_x64.dll";
+    double seconds = (argc > 2) ? atof(argv[2]) : 10.0;
+    if (seconds <= 0.0) seconds = 10.0;
+
+    HMODULE dll = LoadLibraryA(dllPath);
+    if (!dll) {
+        printf("ERROR: could not load %s\n", dllPath);
+        return 1;
+    }
+
+    RVExtensionFunc rvExtension = (RVExtensionFunc)GetProcAddress(dll, "RVExtension");
+    if (!rvExtension) {
+        printf("ERROR: RVExtension not exported by %s\n", dllPath);
+        return 1;
+    }
+
+    char command[64];
+    snprintf(command, sizeof(command), "synth_bench:%g", seconds);
+    static char output[10240];
+    printf("%s, %g seconds per voice and ISA\n\n", dllPath, seconds);
+    rvExtension(output, sizeof(output), command);
+    if (strcmp(output, "UNKNOWN_COMMAND") == 0) {
+        printf("ERROR: %s is not a bench build (compile it with /DBRIDGE_BENCH)\n", dllPath);
+        return 1;
+    }
+
+    // One result object per line
+    for (const char* p = output; *p; p++) {
+        putchar(*p);
+        if (p[0] == '}' && p[1] == ',') {
+            putchar(',');
+            putchar('\n');
+            p++;
+        } else if (p[0] == '[') {
+            putchar('\n');
+        }
+    }
+    putchar('\n');
+
+    // Process exit unloads the DLL (its DllMain handles shutdown)
+    return strstr(output, "\"agree\":true") ? 0 : 2;
+}
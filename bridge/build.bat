@@ -28,7 +28,7 @@ if not exist nvdaControllerClient.lib (
 
 REM Compile the DLL
 echo Compiling...
-cl /LD /EHsc /O2 /Fe:nvda_arma3_bridge_x64.dll nvda_arma3_bridge.cpp nvdaControllerClient.lib /link /DEF:
+cl /LD /EHsc /O2 /std:c++17 /Fe:nvda_arma3_bridge_x64.dll nvda_arma3_bridge.cpp nvdaControllerClient.lib /link /DEF:
 
 if %ERRORLEVEL% neq 0 (
     echo.
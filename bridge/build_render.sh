@@ -0,0 +1,21 @@
+#!/bin/sh
+# Build script for the offline synth renderer (Linux, no NVDA or audio device)
+# The bridge is compiled with BRIDGE_OFFLINE; see render_timeline.cpp for usage.
+# The binary is written to bridge/render_timeline (gitignored).
+
+cd "$(dirname "$0")" || exit 1
+
+echo "Building render_timeline..."
+g++ -std=c++17 -O2 -DBRIDGE_OFFLINE -o render_timeline render_timeline.cpp nvda_arma3_bridge.cpp -lpthread
+
+if [ $? -ne 0 ]; then
+    echo
+    echo "BUILD FAILED!"
+    exit 1
+fi
+
+echo
+echo "BUILD SUCCESSFUL!"
+echo
+echo "Output: render_timeline"
+echo "Usage:  ./render_timeline timeline.txt out.wav [period_frames]"
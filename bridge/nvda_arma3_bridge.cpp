@@ -12,16 +12,71 @@
  *   - Both tones steady = dead center = FIRE!
  *
  * Build with Visual Studio 2022 Developer Command Prompt:
- *   cl /LD /EHsc /O2 /Fe:nvda_arma3_bridge_x64.dll nvda_arma3_bridge.cpp nvdaControllerClient.lib
+ *   cl /LD /EHsc /O2 /std:c++17 /Fe:nvda_arma3_bridge_x64.dll nvda_arma3_bridge.cpp nvdaControllerClient.lib
+ *
+ * Offline build (Linux, no NVDA or audio device): BRIDGE_OFFLINE swaps Win32, NVDA and
+ * miniaudio for offline_platform.h, and render_timeline.cpp renders scripted commands
+ * through the same synth to WAV or raw float (see build_render.sh).
+ *
+ * Speech Dispatcher:
+ *   NVDA calls are synchronous RPCs, so speak/cancel/braille are pushed onto a
+ *   lock-free queue and sent by a dedicated worker thread. These commands return
+ *   "QUEUED" immediately and never stall the game's simulation thread.
+ *   The worker schedules by NVDA priority class (normal/next/now), coalesces unsent
+ *   speech sharing a key, and drops speech that waited longer than its max age.
+ *   speak_ssml builds SSML (prosody + mark) natively and uses nvdaController_speakSsml
+ *   when NVDA provides NvdaController2, otherwise falls back to plain speakText.
+ *   SSML is spoken synchronously on its own RPC threads (NVDA only reports marks
+ *   while the speakSsml call carrying them is in flight).
+ *   Reached marks are raised to SQF as ExtensionCallback events ("speech_mark"),
+ *   or buffered for speech_poll when no callback is registered.
  *
  * Usage in Arma 3 SQF:
  *   "nvda_arma3_bridge" callExtension "speak:Hello world"
  *   "nvda_arma3_bridge" callExtension "cancel"
  *   "nvda_arma3_bridge" callExtension "braille:Message"
+ *   "nvda_arma3_bridge" callExtension ["speak_priority", ["Menu item", "now", "menu", 0]]  // text,priority,key,maxAge
+ *   "nvda_arma3_bridge" callExtension ["speak_ssml", ["Contact", 30, 15, "", "next"]]  // text,rate%,pitch%,mark,priority
+ *   "nvda_arma3_bridge" callExtension "speech_stats"  // queue depth + RPC latency (JSON)
+ *   "nvda_arma3_bridge" callExtension "speech_poll"   // SSML marks reached: [["mark", age], ...]
  *   "nvda_arma3_bridge" callExtension "test"
  *   "nvda_arma3_bridge" callExtension "aim_start"
  *   "nvda_arma3_bridge" callExtension "aim_update:-0.5,600,0.2,0.5"  // pan,pitch,vertErr,horizErr
+ *     (optional trailing vertThr,horizThr,panVel,vertErrVel - velocities are extrapolated)
  *   "nvda_arma3_bridge" callExtension "aim_stop"
+ *   "nvda_arma3_bridge" callExtension "smoothing:100"  // ms to glide aim/beacon parameters (0 = step)
+ *   "nvda_arma3_bridge" callExtension "audio_config"   // device settings + the open device (JSON)
+ *   "nvda_arma3_bridge" callExtension "audio_config:period_frames,256"  // also backend, periods, sample_rate, mode;
+ *                                                      // reopens an open device; "audio_config:save" writes the .ini
+ *   "nvda_arma3_bridge" callExtension "audio_stats"    // audio callback render cost, deadline histogram, underruns (JSON)
+ *   "nvda_arma3_bridge" callExtension "audio_stats_csv:5"  // append audio_stats to a CSV next to the DLL every 5s, or "off"
+ *   "nvda_arma3_bridge" callExtension "latency_report" // command-to-render p50/p95/p99 per command + device latency (JSON)
+ *   "nvda_arma3_bridge" callExtension "synth_bench:10" // voice render speed per ISA (bench builds only, blocks)
+ *   "nvda_arma3_bridge" callExtension "spatial:radar,binaural"  // aim/radar/beacon/all: pan (default) or binaural
+ *   "nvda_arma3_bridge" callExtension "pan_law:linear" // pan mode law: constant_power (default) or linear
+ *   "nvda_arma3_bridge" callExtension "bus_gain:radar,1.5"  // aim/blip/radar/beacon/master, linear 0-4
+ *   "nvda_arma3_bridge" callExtension "limiter:-1"     // master look-ahead limiter ceiling dBFS, or "off"
+ *   "nvda_arma3_bridge" callExtension "duck:-12"       // radar/beacon level while NVDA speaks (dB), or "off"
+ *   "nvda_arma3_bridge" callExtension "radar_steal:quietest"  // radar voice stealing: oldest (default)/quietest
+ *   "nvda_arma3_bridge" callExtension "radar_stats"    // radar voice pool + beep queue counters (JSON)
+ *   "nvda_arma3_bridge" callExtension "radar_overflow:coalesce"  // full queue: drop_oldest (default)/drop_newest/coalesce
+ *     (radar_beep replies "FULL" when it displaced an older beep, "DROPPED" when it was discarded)
+ *   "nvda_arma3_bridge" callExtension "radar_sweep_start:1000,45"  // audio clock drives the sweep (ms, samples)
+ *   "nvda_arma3_bridge" callExtension ["radar_sweep_hit", [57, 0.3, 12.5, "grass"]]  // sample,pan,distance,material[,azimuth,elevation]
+ *     (sample counts across sweeps: index 57 mod 45 = 12 of sweep 1; hits older than one sweep stay silent)
+ *     (material: a name as above, or the raw surface: "#GdtGrassGreen", "a3\data_f\penetration\plastic.bisurf|vehicle")
+ *   "nvda_arma3_bridge" callExtension "material:#GdtStratisRocky"  // what a surface resolves to (concrete)
+ *   "nvda_arma3_bridge" callExtension "radar_sweep_pos"  // next sample the audio clock plays (wraps every 64 sweeps, -1 = no sweep)
+ *   "nvda_arma3_bridge" callExtension "radar_sweep_stop"
+ *
+ * Typed array form (no string formatting/splitting; returns [reply, resultCode, error]):
+ *   "nvda_arma3_bridge" callExtension ["aim_update", [-0.5, 600, 0.2, 0.5, 0.02, 0.005]]
+ *   "nvda_arma3_bridge" callExtension ["radar_beep", [0.3, 12.5, "grass"]]
+ *   "nvda_arma3_bridge" callExtension ["beacon_update", [-0.2]]
+ *   "nvda_arma3_bridge" callExtension ["beacon_update", [0.5, 150, 0]]  // + azimuth,elevation (binaural front/back)
+ *
+ * Frame packet (several sub-commands in one call; replies with per-command codes, e.g. "[0,0,0]"):
+ *   "nvda_arma3_bridge" callExtension ["frame", [["aim_update", -0.5, 600], ["radar_beep", 0.3, 12.5, "grass"], ["aim_blip"]]]
  */
 
 #define UNICODE
@@ -36,56 +91,159 @@
 #define MA_NO_NODE_GRAPH
 #define MA_NO_ENGINE
 
+#ifndef BRIDGE_OFFLINE
 #include <windows.h>
+#endif
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <cstring>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
 #include <atomic>
-
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef BRIDGE_OFFLINE
+// Win32 and a silent NVDA for the render harness (no audio device)
+#include "offline_platform.h"
+#else
 // NVDA Controller Client header
 #include "nvdaController.h"
 
 // miniaudio for real-time audio synthesis
 #include "miniaudio.h"
+#endif
 
 // Arma 3 extension entry points
 extern "C" {
     __declspec(dllexport) void __stdcall RVExtensionVersion(char *output, int outputSize);
     __declspec(dllexport) void __stdcall RVExtension(char *output, int outputSize, const char *function);
     __declspec(dllexport) int __stdcall RVExtensionArgs(char *output, int outputSize, const char *function, const char **args, int argsCnt);
+    __declspec(dllexport) void __stdcall RVExtensionRegisterCallback(int(*callbackProc)(char const *name, char const *function, char const *data));
 }
 
+// Arma's ExtensionCallback entry (set by RVExtensionRegisterCallback, callable from any thread)
+typedef int (*ArmaCallbackFunc)(char const *name, char const *function, char const *data);
+static std::atomic<ArmaCallbackFunc> g_armaCallback(nullptr);
+
 // DLL version string
 static const char* VERSION = "1.5.0";
 
+#ifdef BRIDGE_OFFLINE
+// Offline clock: follows the rendered samples (advanced by offline_render), so a
+// scripted timeline renders the same output every run
+static std::atomic<long long> g_offlineClockNs(0);
+
+static long long now_ns() {
+    return g_offlineClockNs.load(std::memory_order_relaxed);
+}
+#else
+// High resolution timestamps
+static long long now_ns() {
+    static LARGE_INTEGER freq = []() { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return f; }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (long long)((double)counter.QuadPart * 1000000000.0 / (double)freq.QuadPart);
+}
+#endif
+
+static long long now_us() {
+    return now_ns() / 1000;
+}
+
 // ============================================================================
 // Audio Synthesis State (for aim assist)
 // ============================================================================
 
-// Audio parameters (atomic for thread-safe access from audio callback)
-static std::atomic<float> g_aimPan(0.0f);           // -1.0 (left) to +1.0 (right)
-static std::atomic<float> g_aimPitch(550.0f);       // Frequency in Hz (300-800)
-static std::atomic<float> g_aimVertError(1.0f);     // Vertical error 0-1 (0 = centered)
-static std::atomic<float> g_aimHorizError(1.0f);    // Horizontal error 0-1 (0 = centered)
-static std::atomic<float> g_aimVertThreshold(0.02f);  // Adaptive vertical threshold
-static std::atomic<float> g_aimHorizThreshold(0.005f); // Adaptive horizontal threshold
-static std::atomic<bool> g_aimActive(false);        // Whether aim assist is active
-static std::atomic<bool> g_aimMuted(false);         // Mute when no target
-static std::atomic<bool> g_aimHorizEnabled(false);  // Horizontal guidance off by default
-
-// Vertical lock blip state
-static std::atomic<bool> g_aimBlipPending(false);   // Flag to trigger blip
-static double g_blipPhase = 0.0;                    // Blip oscillator phase
-static float g_blipEnvelope = 0.0f;                 // Blip envelope level
-static int g_blipEnvState = 0;                      // 0=idle, 1=attack, 2=sustain, 3=release
-static int g_blipSustainSamples = 0;                // Remaining sustain samples
-
-// Vertical unlock blip state
+// Per-voice parameter block: one writer (command handlers on the game thread) publishes
+// the whole struct, the audio callback copies a consistent snapshot once per buffer.
+// Seqlock over relaxed atomic words, so the reader's copy never observes a torn update
+// (e.g. new pan with old pitch) and the writer never waits for the audio thread.
+template <typename T>
+class ParamBlock {
+    static_assert(std::is_trivially_copyable<T>::value, "ParamBlock needs a plain struct");
+public:
+    ParamBlock() : ParamBlock(T()) {}
+    explicit ParamBlock(const T& initial) : m_value(initial) {
+        store_words(initial);
+    }
+
+    // Writer side: last published values (writer-owned copy, no atomics)
+    const T& get() const { return m_value; }
+
+    // Writer side: publish a complete new parameter set
+    void publish(const T& value) {
+        m_value = value;
+        unsigned int seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);  // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        store_words(value);
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side (audio callback): false if a publish overlapped the copy
+    bool try_read(T& out) const {
+        unsigned int seq = m_seq.load(std::memory_order_acquire);
+        if (seq & 1) return false;
+        unsigned int words[WORD_COUNT];
+        for (int i = 0; i < WORD_COUNT; i++) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_seq.load(std::memory_order_relaxed) != seq) return false;
+        memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+private:
+    static const int WORD_COUNT = (int)((sizeof(T) + sizeof(unsigned int) - 1) / sizeof(unsigned int));
+
+    void store_words(const T& value) {
+        unsigned int words[WORD_COUNT] = {};
+        memcpy(words, &value, sizeof(T));
+        for (int i = 0; i < WORD_COUNT; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    T m_value;
+    std::atomic<unsigned int> m_seq{0};
+    std::atomic<unsigned int> m_words[WORD_COUNT];
+};
+
+// Aim assist parameters
+struct AimParams {
+    float pan = 0.0f;               // -1.0 (left) to +1.0 (right)
+    float pitch = 550.0f;           // Frequency in Hz (300-800)
+    float vertError = 1.0f;         // Vertical error 0-1 (0 = centered)
+    float horizError = 1.0f;        // Horizontal error 0-1 (0 = centered)
+    float vertThreshold = 0.02f;    // Adaptive vertical threshold
+    float horizThreshold = 0.005f;  // Adaptive horizontal threshold
+    bool active = false;            // Whether aim assist is active
+    bool muted = false;             // Mute when no target
+    bool horizEnabled = false;      // Horizontal guidance off by default
+    float panVelocity = 0.0f;       // d pan/dt (per second) for extrapolation, 0 = none
+    float vertErrorVelocity = 0.0f; // d vertError/dt (per second)
+    long long sampleTimeUs = 0;     // When pan/vertError were measured (now_us clock)
+    long long publishedNs = 0;      // now_ns() of the aim_update that published it (latency_report)
+    uint32_t resetCount = 0;        // Bumped by aim_start; the audio thread resets the chirp on change
+};
+static ParamBlock<AimParams> g_aimParams{AimParams()};
+
+// Vertical lock/unlock blip triggers (consumed by the blip voices)
+static std::atomic<bool> g_aimBlipPending(false);
 static std::atomic<bool> g_aimUnlockBlipPending(false);
-static double g_unlockBlipPhase = 0.0;
-static float g_unlockBlipEnvelope = 0.0f;
-static int g_unlockBlipEnvState = 0;
-static int g_unlockBlipSustainSamples = 0;
 
 // ============================================================================
 // Terrain Radar Audio State
@@ -94,27 +252,69 @@ static int g_unlockBlipSustainSamples = 0;
 // Radar active flag
 static std::atomic<bool> g_radarActive(false);
 
-// Ring buffer for pending beeps (producer: command handler, consumer: audio callback)
+// Ring buffer for pending beeps (producer: command handler, consumer: audio callback).
+// One slot stays unused so full (head + 1 == tail) differs from empty (head == tail).
+// The tail only moves by CAS: the consumer after copying a beep, or the producer when it
+// drops the oldest beep to make room, so a copied beep is used only if its CAS won.
 struct RadarBeep {
     float pan;
     float volume;
     int material;
+    float azimuth;      // Degrees, for binaural rendering (pan * 90 unless given)
+    float elevation;
+    long long queuedNs; // now_ns() of the radar_beep command (0 = sweep beep, latency_report)
 };
 static const int RADAR_QUEUE_SIZE = 64;  // Power of 2 for efficient modulo
 static RadarBeep g_radarQueue[RADAR_QUEUE_SIZE];
 static std::atomic<int> g_radarQueueHead(0);  // Next write position (command handler)
 static std::atomic<int> g_radarQueueTail(0);  // Next read position (audio callback)
 
-// Currently playing beep parameters (consumed from queue)
-static float g_radarPlayingPan = 0.0f;
-static float g_radarPlayingVol = 0.5f;
-static int g_radarPlayingMat = 0;
+// Bumped by radar_start/radar_stop: the audio callback stops every radar voice and drops
+// whatever is queued, so playback state is only touched from the audio thread
+static std::atomic<unsigned int> g_radarResetGeneration(0);
 
-// Radar beep state (non-atomic, only accessed in audio callback)
-static double g_radarPhase = 0.0;           // Beep oscillator phase
-static float g_radarEnvelope = 0.0f;        // Current envelope level
-static int g_radarEnvState = 0;             // 0=idle, 1=attack, 2=sustain, 3=release
-static int g_radarSustainSamples = 0;       // Samples remaining in sustain
+// What radar_beep does when the ring is full (radar_overflow)
+enum RadarOverflowPolicy {
+    RADAR_OVERFLOW_DROP_OLDEST = 0,  // Drop the oldest unplayed beep, queue the new one ("FULL")
+    RADAR_OVERFLOW_DROP_NEWEST = 1,  // Discard the new beep ("DROPPED")
+    RADAR_OVERFLOW_COALESCE = 2      // Park it in its pan bucket, replacing an unplayed one there ("FULL")
+};
+static std::atomic<int> g_radarOverflowPolicy(RADAR_OVERFLOW_DROP_OLDEST);
+
+// Coalescing slots: the latest overflowed beep per pan bucket. The audio callback plays a
+// bucket when its sequence differs from the one it played last.
+static const int RADAR_PAN_BUCKETS = 16;
+struct RadarBucketBeep {
+    RadarBeep beep;
+    unsigned int seq;
+};
+static ParamBlock<RadarBucketBeep> g_radarBuckets[RADAR_PAN_BUCKETS];
+static std::atomic<unsigned int> g_radarBucketPlayedSeq[RADAR_PAN_BUCKETS];
+
+// Queue counters (radar_stats)
+static std::atomic<unsigned int> g_radarQueued(0);         // Beeps accepted into the ring
+static std::atomic<unsigned int> g_radarOverflows(0);      // radar_beep calls that found the ring full
+static std::atomic<unsigned int> g_radarDroppedOldest(0);
+static std::atomic<unsigned int> g_radarDroppedNewest(0);
+static std::atomic<unsigned int> g_radarCoalesced(0);      // Unplayed bucket beeps replaced
+static std::atomic<int> g_radarQueuePeak(0);               // Deepest the ring has been
+
+// Radar materials (RadarBeep::material); MATERIAL_NONE means no beep
+enum RadarMaterial {
+    MATERIAL_NONE = -1,
+    MATERIAL_DEFAULT = 0,
+    MATERIAL_GRASS = 1,
+    MATERIAL_CONCRETE = 2,
+    MATERIAL_WOOD = 3,
+    MATERIAL_METAL = 4,
+    MATERIAL_WATER = 5,
+    MATERIAL_MAN = 6,
+    MATERIAL_GLASS = 7,
+    MATERIAL_COUNT = 8
+};
+static const char* MATERIAL_NAMES[MATERIAL_COUNT] = {
+    "default", "grass", "concrete", "wood", "metal", "water", "man", "glass"
+};
 
 // Radar material frequencies (Hz)
 static const float RADAR_FREQ_GRASS = 200.0f;
@@ -126,27 +326,61 @@ static const float RADAR_FREQ_MAN = 800.0f;
 static const float RADAR_FREQ_GLASS = 700.0f;
 static const float RADAR_FREQ_DEFAULT = 350.0f;
 
-// Radar envelope timing (in samples at 44100 Hz)
-static const int RADAR_ATTACK_SAMPLES = 88;    // 2ms attack
-static const int RADAR_SUSTAIN_SAMPLES = 882;  // 20ms sustain
-static const int RADAR_RELEASE_SAMPLES = 132;  // 3ms release
+// Radar envelope timing (converted to samples at the device rate)
+static const float RADAR_ATTACK_MS = 2.0f;
+static const float RADAR_SUSTAIN_MS = 20.0f;
+static const float RADAR_RELEASE_MS = 3.0f;
 
 // Radar volume
 static const float RADAR_BASE_VOLUME = 0.015f;  // Base volume for radar beeps
 
+// Radar voice pool: each queued beep gets its own voice, so beeps issued faster than the
+// 25ms envelope overlap instead of queueing behind each other. When every voice is busy
+// one is stolen: the oldest-started (default) or the currently quietest.
+static const int RADAR_VOICE_COUNT = 8;
+enum RadarStealPolicy { RADAR_STEAL_OLDEST = 0, RADAR_STEAL_QUIETEST = 1 };
+static std::atomic<int> g_radarStealPolicy(RADAR_STEAL_OLDEST);
+
+// Radar pool stats (written by the audio callback, read by radar_stats)
+static std::atomic<unsigned int> g_radarBeepsStarted(0);
+static std::atomic<unsigned int> g_radarVoicesStolen(0);
+static std::atomic<int> g_radarVoicesActive(0);   // Playing at the end of the last block
+static std::atomic<int> g_radarVoicesPeak(0);
+
+// Radar sweep scheduler: SQF uploads the hit for each sweep sample index, and the audio
+// callback starts that index's beep at its exact frame within the sweep period, so the
+// sweep rhythm follows the audio clock instead of the game's frame rate
+static const int RADAR_SWEEP_MAX_SAMPLES = 256;
+// Sample numbers SQF sees wrap every 64 sweeps (at most 16384), so they stay exact
+// through SQF's 6-significant-digit number formatting however long the sweep runs
+static const int RADAR_SWEEP_WRAP_SWEEPS = 64;
+struct RadarSweepHit {
+    RadarBeep beep = {};
+    bool audible = false;            // False = no hit yet / "none": the slot stays silent
+    unsigned int sweep = 0;          // Sweep it was uploaded for; older than the last sweep = silent
+};
+static ParamBlock<RadarSweepHit> g_radarSweepHits[RADAR_SWEEP_MAX_SAMPLES];
+static std::atomic<bool> g_radarSweepActive(false);
+static std::atomic<int> g_radarSweepPeriodFrames(0);
+static std::atomic<int> g_radarSweepSampleCount(0);
+static std::atomic<unsigned int> g_radarSweepGeneration(0);  // Bumped by radar_sweep_start (restarts the clock)
+static std::atomic<long long> g_radarSweepPosition(-1);     // Next sample the clock plays, not wrapped
+
 // ============================================================================
 // Navigation Beacon Audio State
 // ============================================================================
 
-// Beacon active flag and pan parameter
-static std::atomic<bool> g_beaconActive(false);
-static std::atomic<float> g_beaconPan(0.0f);     // -1.0 (left) to +1.0 (right)
-
-// Beacon oscillator state (non-atomic, only accessed in audio callback)
-static double g_beaconPhase = 0.0;               // Oscillator phase
-static double g_beaconPulsePhase = 0.0;          // Pulse envelope phase
-static float g_beaconLpfState = 0.0f;            // Low pass filter state
-static float g_beaconEnvelopeState = 0.0f;       // Smooth envelope level (0-1)
+// Beacon parameters
+struct BeaconParams {
+    float pan = 0.0f;               // -1.0 (left) to +1.0 (right)
+    bool active = false;
+    bool hasDirection = false;      // azimuth/elevation were sent (binaural: full circle)
+    float azimuth = 0.0f;           // Degrees: 0 ahead, +90 right, +-180 behind
+    float elevation = 0.0f;         // Degrees above the horizon
+    long long publishedNs = 0;      // now_ns() of the beacon_update that published it (latency_report)
+    uint32_t resetCount = 0;        // Bumped by beacon_start/stop; the audio thread resets the voice on change
+};
+static ParamBlock<BeaconParams> g_beaconParams{BeaconParams()};
 
 // Beacon audio constants
 static const float BEACON_FREQ_MIN = 400.0f;      // Frequency when off center
@@ -159,26 +393,366 @@ static const float BEACON_CENTER_THRESHOLD = 0.05f; // abs(pan) below this = ste
 static const float BEACON_ATTACK_MS = 5.0f;       // Envelope attack (hearing safety)
 static const float BEACON_RELEASE_MS = 5.0f;      // Envelope release (hearing safety)
 
+// ============================================================================
+// Mixer State
+// ============================================================================
+
+// Voices are summed per bus, each bus at its own gain, then the master gain and a
+// look-ahead peak limiter keep the sum below the ceiling (busy sweeps + blips used to clip)
+enum MixBus { MIX_BUS_AIM = 0, MIX_BUS_BLIP = 1, MIX_BUS_RADAR = 2, MIX_BUS_BEACON = 3, MIX_BUS_COUNT = 4 };
+static const char* const MIX_BUS_NAMES[MIX_BUS_COUNT] = { "aim", "blip", "radar", "beacon" };
+static const float MIX_GAIN_MAX = 4.0f;               // +12 dB: room to lift the quiet voices
+
+struct MixerParams {
+    float busGain[MIX_BUS_COUNT] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float masterGain = 1.0f;
+    bool limiterEnabled = true;
+    float limiterCeiling = 0.891f;                   // Linear peak ceiling (-1 dBFS)
+    bool duckEnabled = true;                         // Duck radar/beacon while NVDA speaks
+    float duckGain = 0.25f;                          // Ducked level (-12 dB)
+    float duckAttackMs = 30.0f;                      // Time to reach the ducked level
+    float duckHoldMs = 300.0f;                       // Stay ducked this long after speech ends
+    float duckReleaseMs = 500.0f;                    // Time to return to full level
+};
+static ParamBlock<MixerParams> g_mixerParams{MixerParams()};
+
+// Look-ahead limiter: gain reduction starts this far ahead of a peak (and delays the output as much)
+static const float LIMITER_LOOKAHEAD_MS = 2.0f;
+static const float LIMITER_RELEASE_MS = 60.0f;        // Recovery after the peak has passed
+static const float LIMITER_CEILING_DB_MIN = -24.0f;
+
+// Buses ducked while NVDA speaks (aim guidance stays at full level)
+static const bool MIX_BUS_DUCKED[MIX_BUS_COUNT] = { false, false, true, true };
+
+// Speech activity for ducking, written by the speech worker and the NVDA mark callback.
+// NVDA reports no end of speech, so each sent utterance extends an estimate of when
+// speaking stops (text length / speaking rate); SSML speech also carries a hidden
+// completion mark that ends the estimate as soon as NVDA reaches it.
+static const int SPEECH_CPS_DEFAULT = 15;                  // Characters per second NVDA speaks
+static std::atomic<long long> g_speechBusyUntilUs(LLONG_MIN / 2);  // now_us() when speech is expected to end
+static std::atomic<unsigned int> g_speechDoneSeq(0);       // Completion mark that may end it early (0 = none)
+static std::atomic<int> g_speechCharsPerSec(SPEECH_CPS_DEFAULT);
+static std::atomic<unsigned int> g_duckGainMilli(1000);    // Current duck gain x 1000 (audio_stats)
+
+// Limiter stats (written by the audio callback, read by audio_stats)
+static std::atomic<unsigned long long> g_limiterFrames(0);   // Frames played with gain reduction
+static std::atomic<unsigned int> g_limiterMaxReductionCdb(0); // Deepest reduction, 1/100 dB
+
+// Pan law for the "pan" spatial mode: constant power (default, equal loudness across
+// the field) or the original linear law (near ear at 1, center +3 dB over the edges)
+enum PanLaw { PAN_LAW_CONSTANT_POWER = 0, PAN_LAW_LINEAR = 1 };
+static std::atomic<int> g_panLaw(PAN_LAW_CONSTANT_POWER);
+
 // Audio device state
+#ifndef BRIDGE_OFFLINE
+static ma_context g_audioContext;   // Backend chosen by audio_config
 static ma_device g_audioDevice;
+#endif
 static bool g_audioInitialized = false;
-static double g_phase = 0.0;           // Primary tone phase
-static double g_pulsePhase = 0.0;      // Primary tone pulse envelope phase
-static double g_clickPhase = 0.0;      // Secondary click tone phase
-static double g_clickPulsePhase = 0.0; // Secondary click pulse envelope phase
-static float g_clickLpfState = 0.0f;   // Low pass filter state for click tone
-static float g_clickEnvelopeState = 0.0f;  // Current envelope level (0-1) for smooth attack/release
-static float g_primaryEnvelopeState = 0.0f;  // Current envelope level for primary tone
-static bool g_prevPulseOn = false;             // Track pulse on/off for chirp reset
-static float g_chirpTime = 100.0f;            // Time since chirp start (large = fully decayed)
 
 // Audio constants
-static const int SAMPLE_RATE = 44100;
+static const int SAMPLE_RATE_DEFAULT = 44100;  // Offline, and devices whose native rate is out of range
+static const int SAMPLE_RATE_MIN = 22050;
+static const int SAMPLE_RATE_MAX = 96000;
+
+// Output rate of the device (audio_config). Only changed by set_sample_rate while no
+// device is running, so the audio thread reads it (and everything derived) without sync.
+static int g_sampleRate = SAMPLE_RATE_DEFAULT;
+
+// Milliseconds to whole samples at the device rate
+static inline int ms_to_samples(float ms) {
+    return (int)(ms * g_sampleRate / 1000.0f + 0.5f);
+}
 static const float BASE_VOLUME = 0.01f;  // Quiet but audible
 
 // Shutdown flag for clean exit
 static std::atomic<bool> g_shuttingDown(false);
 
+// Render cost of audio_callback (reported by audio_stats)
+static std::atomic<unsigned int> g_audioBuffers(0);
+static std::atomic<unsigned long long> g_audioFrames(0);
+static std::atomic<unsigned long long> g_audioRenderNs(0);   // Total time spent rendering
+static std::atomic<unsigned int> g_audioRenderMaxNs(0);      // Slowest buffer
+
+// Deadline tracking: render time as a share of the buffer's own duration, by bucket
+// (upper edges in percent; the last bucket is an overrun, the device would underrun)
+static const int RENDER_HIST_EDGES_PCT[] = { 10, 25, 50, 75, 100 };
+static const int RENDER_HIST_BUCKETS = 6;
+static std::atomic<unsigned int> g_audioRenderHist[RENDER_HIST_BUCKETS];
+static std::atomic<unsigned int> g_audioOverruns(0);         // Renders longer than their buffer
+static std::atomic<unsigned int> g_audioLateCallbacks(0);    // Callback came > 1.5 buffers after the last
+static std::atomic<unsigned int> g_audioMaxFrames(0);        // Largest buffer the device asked for
+
+// Control-to-render latency (latency_report): each published state carries the now_ns()
+// of its command, and the audio thread records how long it waited for the first buffer
+// rendering it (most recent LATENCY_HISTORY per command, microseconds)
+enum LatencyCommand {
+    LATENCY_AIM_UPDATE = 0,
+    LATENCY_BEACON_UPDATE = 1,
+    LATENCY_RADAR_BEEP = 2,
+    LATENCY_COMMAND_COUNT = 3
+};
+static const char* const LATENCY_COMMAND_NAMES[LATENCY_COMMAND_COUNT] = { "aim_update", "beacon_update", "radar_beep" };
+static const int LATENCY_HISTORY = 256;
+static std::atomic<unsigned int> g_latencyUs[LATENCY_COMMAND_COUNT][LATENCY_HISTORY];
+static std::atomic<unsigned int> g_latencyCount[LATENCY_COMMAND_COUNT];
+static long long g_renderStartNs = 0;            // Start of the buffer being rendered (audio thread only)
+
+// Output buffering after the render, from the opened device (0 until opened, and offline)
+static std::atomic<unsigned int> g_devicePeriodFrames(0);
+static std::atomic<unsigned int> g_devicePeriods(0);
+static std::atomic<unsigned int> g_deviceSampleRate(0);
+
+// Spatial mode per voice (spatial command; the binaural model is in its own section)
+enum SpatialMode { SPATIAL_PAN = 0, SPATIAL_BINAURAL = 1 };
+enum SpatialVoice { SPATIAL_AIM = 0, SPATIAL_RADAR = 1, SPATIAL_BEACON = 2, SPATIAL_VOICE_COUNT = 3 };
+static const char* const SPATIAL_VOICE_NAMES[SPATIAL_VOICE_COUNT] = { "aim", "radar", "beacon" };
+static std::atomic<int> g_spatialMode[SPATIAL_VOICE_COUNT];  // SpatialMode per voice (zero = pan)
+
+// Control parameters as seen by one audio buffer. Each voice block is consistent on its
+// own; a "frame" command additionally applies several sub-commands between two increments
+// of g_controlSeq (odd = frame in progress), so the callback keeps its previous snapshot
+// rather than mixing voices from before and after the frame. One-shot triggers (blips,
+// queued radar beeps, radar resets) are not part of the snapshot; they stay pending while
+// a frame is open (see frame_gate_open).
+struct ControlSnapshot {
+    AimParams aim;
+    BeaconParams beacon;
+    MixerParams mixer;
+    bool radarActive = false;
+    int spatialMode[SPATIAL_VOICE_COUNT] = {};
+};
+static std::atomic<unsigned int> g_controlSeq(0);
+static ControlSnapshot g_controlSnapshot;  // Last consistent snapshot (audio callback only)
+
+// Gate for consuming a one-shot trigger (audio callback only): frame_gate_open reads
+// g_controlSeq before the trigger, frame_gate_still_open checks it after. A frame open at
+// either point leaves the trigger for a later block, so it sounds with the rest of its frame.
+static bool frame_gate_open(unsigned int& seq) {
+    seq = g_controlSeq.load(std::memory_order_acquire);
+    return (seq & 1) == 0;
+}
+
+static bool frame_gate_still_open(unsigned int seq) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return g_controlSeq.load(std::memory_order_relaxed) == seq;
+}
+
+// Read all control parameters once per buffer (audio callback only, never blocks)
+static const ControlSnapshot& read_control_snapshot() {
+    unsigned int seq = g_controlSeq.load(std::memory_order_acquire);
+    if (seq & 1) {
+        return g_controlSnapshot;
+    }
+
+    ControlSnapshot next;
+    bool consistent = g_aimParams.try_read(next.aim) && g_beaconParams.try_read(next.beacon) &&
+                      g_mixerParams.try_read(next.mixer);
+    next.radarActive = g_radarActive.load(std::memory_order_relaxed);
+    for (int v = 0; v < SPATIAL_VOICE_COUNT; v++) {
+        next.spatialMode[v] = g_spatialMode[v].load(std::memory_order_relaxed);
+    }
+
+    // A voice or frame update overlapped the read: keep the previous snapshot this buffer
+    if (!consistent || g_controlSeq.load(std::memory_order_acquire) != seq) {
+        return g_controlSnapshot;
+    }
+    g_controlSnapshot = next;
+    return g_controlSnapshot;
+}
+
+// Record one command's wait for the buffer that renders it (audio thread only)
+static void record_control_latency(int command, long long publishedNs) {
+    long long waitNs = g_renderStartNs - publishedNs;
+    unsigned int slot = g_latencyCount[command].load(std::memory_order_relaxed) % LATENCY_HISTORY;
+    g_latencyUs[command][slot].store((unsigned int)(waitNs > 0 ? waitNs / 1000 : 0), std::memory_order_relaxed);
+    g_latencyCount[command].fetch_add(1, std::memory_order_release);
+}
+
+// Aim and beacon states seen for the first time in this buffer
+static void record_snapshot_latency(const ControlSnapshot& ctl) {
+    static long long lastAimNs = 0;
+    static long long lastBeaconNs = 0;
+    if (ctl.aim.publishedNs != lastAimNs) {
+        lastAimNs = ctl.aim.publishedNs;
+        if (lastAimNs != 0) record_control_latency(LATENCY_AIM_UPDATE, lastAimNs);
+    }
+    if (ctl.beacon.publishedNs != lastBeaconNs) {
+        lastBeaconNs = ctl.beacon.publishedNs;
+        if (lastBeaconNs != 0) record_control_latency(LATENCY_BEACON_UPDATE, lastBeaconNs);
+    }
+}
+
+// ============================================================================
+// Parameter Smoothing (audio thread)
+// ============================================================================
+
+// Linear ramp toward the latest published value. Updates arrive at 10-20Hz; gliding
+// over the ramp time instead of stepping at a buffer boundary avoids zipper noise in
+// pan gains and pitch.
+struct ParamRamp {
+    float value = 0.0f;
+    float target = 0.0f;
+    float step = 0.0f;
+    int remaining = 0;          // Samples left in the current ramp
+
+    // Start gliding to a new target (rampSamples <= 0 jumps straight there)
+    void retarget(float newTarget, int rampSamples) {
+        if (rampSamples <= 0) {
+            value = target = newTarget;
+            remaining = 0;
+            return;
+        }
+        if (newTarget == target) return;  // Keep the ramp already in progress
+        target = newTarget;
+        step = (target - value) / rampSamples;
+        remaining = rampSamples;
+    }
+
+    // Move the current value (keeping the target) and glide from there
+    void rebase(float newValue, int rampSamples) {
+        value = newValue;
+        step = (rampSamples > 0) ? (target - value) / rampSamples : 0.0f;
+        remaining = (rampSamples > 0) ? rampSamples : 0;
+        if (remaining == 0) value = target;
+    }
+
+    // Per-sample value
+    float next() {
+        if (remaining > 0) {
+            value = (--remaining == 0) ? target : value + step;
+        }
+        return value;
+    }
+
+    // Per-block value: advance a whole buffer at once
+    float advance(int samples) {
+        if (remaining > 0) {
+            if (samples >= remaining) {
+                value = target;
+                remaining = 0;
+            } else {
+                value += step * samples;
+                remaining -= samples;
+            }
+        }
+        return value;
+    }
+};
+
+static const float PARAM_RAMP_DEFAULT_MS = 100.0f;  // One 10Hz SQF update interval
+static const float PARAM_RAMP_MAX_MS = 500.0f;
+static std::atomic<int> g_paramRampSamples((int)(PARAM_RAMP_DEFAULT_MS * SAMPLE_RATE_DEFAULT / 1000));
+
+// ============================================================================
+// Envelopes (audio thread)
+// ============================================================================
+
+// Linear attack/hold/release envelope with its times in ms. The per-sample steps are
+// converted at the device rate and recomputed when it changes (update_rate is a compare
+// once per buffer or trigger). Two uses:
+//   - One-shot (blips, radar beeps): trigger() rises over the attack, holds at 1, falls
+//     over the release and goes idle; render() writes the levels a block at a time.
+//   - Follower (aim tone and click pulses, beacon): follow(target) slews toward a
+//     gate level each sample at the attack/release rates; the hold time is unused.
+class Envelope {
+public:
+    Envelope(float attackMs, float holdMs, float releaseMs)
+        : m_attackMs(attackMs), m_holdMs(holdMs), m_releaseMs(releaseMs) {}
+
+    bool active() const { return m_stage != STAGE_IDLE; }
+    bool attacking() const { return m_stage == STAGE_ATTACK; }
+    float level() const { return m_level; }
+
+    void reset() {
+        m_stage = STAGE_IDLE;
+        m_level = 0.0f;
+    }
+
+    void update_rate() {
+        if (m_rate == g_sampleRate) return;
+        m_rate = g_sampleRate;
+        const float samplesPerMs = m_rate / 1000.0f;
+        m_attackStep = 1.0f / (m_attackMs * samplesPerMs);
+        m_releaseStep = 1.0f / (m_releaseMs * samplesPerMs);
+        m_holdSamples = ms_to_samples(m_holdMs);
+    }
+
+    // One-shot: restart from silence
+    void trigger() {
+        update_rate();
+        m_stage = STAGE_ATTACK;
+        m_level = 0.0f;
+        m_holdLeft = m_holdSamples;
+    }
+
+    // One-shot: levels until the envelope ends or n samples; returns the samples written
+    int render(float* out, int n) {
+        int count = 0;
+        while (count < n && m_stage != STAGE_IDLE) {
+            switch (m_stage) {
+                case STAGE_ATTACK:
+                    m_level += m_attackStep;
+                    if (m_level >= 1.0f) {
+                        m_level = 1.0f;
+                        m_stage = STAGE_HOLD;
+                    }
+                    break;
+                case STAGE_HOLD:
+                    if (--m_holdLeft <= 0) m_stage = STAGE_RELEASE;
+                    break;
+                default:
+                    m_level -= m_releaseStep;
+                    if (m_level <= 0.0f) {
+                        m_level = 0.0f;
+                        m_stage = STAGE_IDLE;
+                    }
+                    break;
+            }
+            out[count++] = m_level;
+        }
+        return count;
+    }
+
+    // Follower: one sample toward target (0-1)
+    float follow(float target) {
+        if (m_level < target) {
+            m_level += m_attackStep;
+            if (m_level > target) m_level = target;
+        } else if (m_level > target) {
+            m_level -= m_releaseStep;
+            if (m_level < target) m_level = target;
+        }
+        return m_level;
+    }
+
+private:
+    enum Stage { STAGE_IDLE = 0, STAGE_ATTACK = 1, STAGE_HOLD = 2, STAGE_RELEASE = 3 };
+
+    float m_attackMs;
+    float m_holdMs;
+    float m_releaseMs;
+    int m_rate = 0;                // Rate the steps were converted at (0 = not yet)
+    float m_attackStep = 0.0f;     // Level change per sample
+    float m_releaseStep = 0.0f;
+    int m_holdSamples = 0;
+    int m_holdLeft = 0;
+    int m_stage = STAGE_IDLE;
+    float m_level = 0.0f;
+};
+
+// Aim motion extrapolation horizon (see AimVoice)
+static const float AIM_EXTRAPOLATE_MAX_MS = 150.0f;
+
+// Pan-dependent aim voice parameters (recomputed per sample only while pan is ramping)
+struct AimPanShape {
+    float panMagnitude;
+    bool secondaryActive;
+    float secondaryPulseRate;
+    uint32_t clickPhaseInc;
+    uint32_t clickPulseInc;
+};
+
 // Constants for two-tone audio
 static const float CLICK_FREQ_MIN = 500.0f;     // Frequency at activation threshold
 static const float CLICK_FREQ_MAX = 560.0f;     // Frequency at center (pan = 0)
@@ -205,1029 +779,4708 @@ static const float CHIRP_DOWN_OCTAVE_MIX = 0.5f;  // Octave harmonic volume for
 // Vertical lock blip constants
 static const float BLIP_FREQ = 800.0f;              // 800 Hz for lock
 static const float UNLOCK_BLIP_FREQ = 500.0f;       // 500 Hz for unlock
-static const int BLIP_ATTACK_SAMPLES = 44;          // ~1ms attack
-static const int BLIP_SUSTAIN_SAMPLES = 882;        // 20ms sustain
-static const int BLIP_RELEASE_SAMPLES = 88;         // ~2ms release
+static const float BLIP_ATTACK_MS = 1.0f;
+static const float BLIP_SUSTAIN_MS = 20.0f;
+static const float BLIP_RELEASE_MS = 2.0f;
 static const float BLIP_VOLUME = 0.30f;             // Loud blip (4x increase for gunfight audibility)
 
-// Audio callback - generates two-tone precision feedback in real-time
-void audio_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
-    (void)pInput;
-    (void)pDevice;
-
-    float* output = (float*)pOutput;
+// ============================================================================
+// Oscillators (32-bit fixed-point phase accumulators)
+// ============================================================================
 
-    // FAST EXIT if shutting down - zero output and return immediately
-    if (g_shuttingDown.load()) {
-        memset(output, 0, frameCount * 2 * sizeof(float));
-        return;
+// A phase is an unsigned 32-bit fraction of a cycle: 2^32 = one full period, so
+// advancing is an integer add that wraps for free (no fmod, no double precision).
+// Sine comes from a table with linear interpolation; triangle, saw and square are
+// computed from the phase directly; a pulse envelope's "sin > 0" is the first half cycle.
+static float g_phasePerHz = 4294967296.0f / SAMPLE_RATE_DEFAULT;  // Phase increment for 1 Hz (set_sample_rate)
+static const int SINE_TABLE_BITS = 11;
+static const int SINE_TABLE_SIZE = 1 << SINE_TABLE_BITS;        // 2048 points, < -100 dB error
+static float g_sineTable[SINE_TABLE_SIZE + 1];                  // +1 guard point for interpolation
+
+static bool init_sine_table() {
+    for (int i = 0; i <= SINE_TABLE_SIZE; i++) {
+        g_sineTable[i] = (float)sin(2.0 * PI * i / SINE_TABLE_SIZE);
     }
+    return true;
+}
+static const bool g_sineTableReady = init_sine_table();
 
-    // Read current parameters atomically
-    float pan = g_aimPan.load();
-    float freq = g_aimPitch.load();
-    float vertError = g_aimVertError.load();
-    float horizError = g_aimHorizError.load();
-    float vertThreshold = g_aimVertThreshold.load();    // Adaptive threshold from SQF
-    float horizThreshold = g_aimHorizThreshold.load();  // Adaptive threshold from SQF
-    bool active = g_aimActive.load();
-    bool muted = g_aimMuted.load();
-
-    // Calculate per-channel gains for primary tone stereo panning
-    // Pan: -1 = full left, 0 = center, +1 = full right
-    float leftGain = (pan <= 0.0f) ? 1.0f : (1.0f - pan);
-    float rightGain = (pan >= 0.0f) ? 1.0f : (1.0f + pan);
-
-    // Calculate primary tone pulse rate based on vertical error
-    // At dead center (vertError < threshold): continuous tone (pulseRate = 0)
-    // Near target: fast clicks, far from target: slow clicks
-    // Full dynamic range spread across useful aiming area [vertThreshold, VERT_ACTIVATE_THRESHOLD]
-    float primaryPulseRate = 0.0f;
-    if (vertError >= vertThreshold) {
-        // Map vertError from [vertThreshold, VERT_ACTIVATE_THRESHOLD] to [MAX_PULSE_RATE, MIN_PULSE_RATE]
-        // Near target = fast clicks, far = slow clicks
-        float t = (vertError - vertThreshold) / (VERT_ACTIVATE_THRESHOLD - vertThreshold);
-        t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;  // Clamp to [0,1]
-        primaryPulseRate = MAX_PULSE_RATE + t * (MIN_PULSE_RATE - MAX_PULSE_RATE);
-    }
-    // When vertError < vertThreshold (on target), pulseRate stays 0 = continuous smooth tone
+// Phase increment per sample for a frequency in Hz
+static inline uint32_t phase_inc(float freq) {
+    return (uint32_t)(int64_t)(freq * g_phasePerHz);
+}
 
-    // Calculate secondary click pulse rate based on pan magnitude (distance from center)
-    // Only active when roughly facing target (abs(pan) < 0.2)
-    // Clicks speed up as you approach target, then go smooth when on target
-    float panMagnitude = fabsf(pan);
-    bool secondaryActive = g_aimHorizEnabled.load() && (panMagnitude < HORIZ_ACTIVATE_THRESHOLD);
-    float secondaryPulseRate = 0.0f;
-    if (secondaryActive && panMagnitude >= horizThreshold) {
-        // Map pan from [horizThreshold, HORIZ_ACTIVATE_THRESHOLD] to [MAX_PULSE_RATE, MIN_PULSE_RATE]
-        // Near target = fast clicks, near edge of activation = slow clicks
-        float t = (panMagnitude - horizThreshold) / (HORIZ_ACTIVATE_THRESHOLD - horizThreshold);
-        t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;  // Clamp to [0,1]
-        secondaryPulseRate = MAX_PULSE_RATE + t * (MIN_PULSE_RATE - MAX_PULSE_RATE);
+// Switch the synth to a new output rate (no device running). Rates given in samples
+// (smoothing ramp, radar sweep period) are rescaled; false if the rate is unchanged.
+static bool set_sample_rate(int sampleRate) {
+    int oldRate = g_sampleRate;
+    if (sampleRate == oldRate) return false;
+    g_sampleRate = sampleRate;
+    g_phasePerHz = 4294967296.0f / sampleRate;
+    g_paramRampSamples.store((int)((long long)g_paramRampSamples.load() * sampleRate / oldRate));
+    int sweepFrames = g_radarSweepPeriodFrames.load();
+    if (sweepFrames > 0) {
+        g_radarSweepPeriodFrames.store((int)((long long)sweepFrames * sampleRate / oldRate));
+        g_radarSweepGeneration.fetch_add(1, std::memory_order_release);
     }
-    // When panMagnitude < horizThreshold (on target), pulseRate stays 0 = continuous smooth tone
+    return true;
+}
 
-    // Calculate click frequency: sweep from 500 Hz (at threshold) to 560 Hz (at center)
-    // Uses HORIZ_ACTIVATE_THRESHOLD so it auto-scales if threshold changes
-    float clickFreq = CLICK_FREQ_MAX;  // Default to center frequency
-    if (secondaryActive) {
-        // Map pan from [0, threshold] to frequency [560, 500]
-        float t = panMagnitude / HORIZ_ACTIVATE_THRESHOLD;  // 0 at center, 1 at threshold
-        clickFreq = CLICK_FREQ_MAX + t * (CLICK_FREQ_MIN - CLICK_FREQ_MAX);
-    }
+static inline float osc_sine(uint32_t phase) {
+    uint32_t index = phase >> (32 - SINE_TABLE_BITS);
+    float frac = (float)(phase & ((1u << (32 - SINE_TABLE_BITS)) - 1)) * (1.0f / (float)(1u << (32 - SINE_TABLE_BITS)));
+    float a = g_sineTable[index];
+    return a + (g_sineTable[index + 1] - a) * frac;
+}
 
-    // Low pass filter coefficient for click tone (one-pole filter)
-    static const float clickLpfAlpha = 1.0f - expf(-2.0f * (float)PI * CLICK_LPF_CUTOFF / SAMPLE_RATE);
+// Phase as 0..1 (for the shapes below)
+static inline float osc_unit(uint32_t phase) {
+    return (float)(phase >> 8) * (1.0f / 16777216.0f);
+}
 
-    // Attack/release coefficients for smooth envelope transitions
-    static const float samplesPerMs = SAMPLE_RATE / 1000.0f;
-    static const float clickAttackCoef = 1.0f / (CLICK_ATTACK_MS * samplesPerMs);
-    static const float clickReleaseCoef = 1.0f / (CLICK_RELEASE_MS * samplesPerMs);
-    static const float primaryAttackCoef = 1.0f / (PRIMARY_ATTACK_MS * samplesPerMs);
-    static const float primaryReleaseCoef = 1.0f / (PRIMARY_RELEASE_MS * samplesPerMs);
+// Triangle: -1 at phase 0.5, +1 at 0/1 (same orientation as 4|x-0.5|-1)
+static inline float osc_triangle(uint32_t phase) {
+    return 4.0f * fabsf(osc_unit(phase) - 0.5f) - 1.0f;
+}
 
-    // Phase increments per sample
-    // Note: primaryPhaseInc is computed per-sample inside the loop (frequency varies during chirp sweeps)
-    double primaryPulseInc = (2.0 * PI * primaryPulseRate) / SAMPLE_RATE;
-    double clickPhaseInc = (2.0 * PI * clickFreq) / SAMPLE_RATE;
-    double clickPulseInc = (2.0 * PI * secondaryPulseRate) / SAMPLE_RATE;
+// Rising sawtooth -1..+1
+static inline float osc_saw(uint32_t phase) {
+    return 2.0f * osc_unit(phase) - 1.0f;
+}
 
-    for (ma_uint32 i = 0; i < frameCount; i++) {
-        float leftSample = 0.0f;
-        float rightSample = 0.0f;
+// True during the first half cycle (where sin(phase) > 0)
+static inline bool osc_first_half(uint32_t phase) {
+    return phase < 0x80000000u;
+}
 
-        if (active && !muted) {
-            // ================================================================
-            // Primary tone (vertical precision) - panned triangle wave with directional chirp
-            // ================================================================
+// Band-limited (PolyBLEP) waveforms: a naive square/saw/pulse jumps instantly, which
+// aliases badly at radar pitches (400-800 Hz). PolyBLEP subtracts a two-sample polynomial
+// residual around each jump, so the partials above Nyquist mostly vanish. Polynomials
+// only - no transcendental calls per sample.
+
+// Residual for a unit-height step (+2 scale) at phase 0; t and dt as fractions of a cycle
+static inline float poly_blep(uint32_t phase, uint32_t inc) {
+    if (inc == 0) return 0.0f;
+    if (phase < inc) {
+        float t = (float)phase / (float)inc;            // 0..1 just after the jump
+        return t + t - t * t - 1.0f;
+    }
+    if (phase > 0u - inc) {
+        float t = ((float)phase - 4294967296.0f) / (float)inc;  // -1..0 just before the jump
+        return t * t + t + t + 1.0f;
+    }
+    return 0.0f;
+}
 
-            // Detect rising edge of pulse (start of new click) to reset chirp
-            bool currentPulseOn = (primaryPulseRate > 0.0f) ? (sin(g_pulsePhase) > 0.0f) : true;
-            if (currentPulseOn && !g_prevPulseOn) {
-                g_chirpTime = 0.0f;  // Reset chirp at start of each new click
-            }
-            g_prevPulseOn = currentPulseOn;
-
-            // Determine sweep direction from pitch vs center
-            // Dead zone matches adaptive on-target threshold (no more gap at long range)
-            // Aim below target (pitch < 550) → descending pew: freq+range → freq → "move up"
-            // Aim above target (pitch > 550) → ascending whoop: freq → freq+range → "move down"
-            float deadZoneHz = vertThreshold * 250.0f;  // Convert vertThreshold to Hz
-            float instantFreq;
-            if (freq < CHIRP_CENTER_FREQ - deadZoneHz) {
-                // "Move up" — descending pew: starts at freq+range, decays to freq
-                instantFreq = freq + CHIRP_SWEEP_RANGE * expf(-CHIRP_SWEEP_DECAY * g_chirpTime);
-            } else if (freq > CHIRP_CENTER_FREQ + deadZoneHz) {
-                // "Move down" — ascending whoop: starts at freq, rises to freq+range
-                instantFreq = freq + CHIRP_SWEEP_RANGE * (1.0f - expf(-CHIRP_SWEEP_DECAY * g_chirpTime));
-            } else {
-                // Within on-target zone — no sweep, steady tone
-                instantFreq = freq;
-            }
+// Rising sawtooth -1..+1 (drops at phase 0)
+static inline float osc_saw_blep(uint32_t phase, uint32_t inc) {
+    return osc_saw(phase) - poly_blep(phase, inc);
+}
 
-            // Per-sample phase increment (variable frequency due to chirp)
-            double primaryPhaseInc = (2.0 * PI * (double)instantFreq) / SAMPLE_RATE;
-            g_chirpTime += 1.0f / SAMPLE_RATE;
-
-            // Triangle waveform: map phase [0, 2*PI] to triangle [-1, +1]
-            // "Move down" adds octave harmonic for distinct richer timbre
-            float normPhase = (float)(fmod(g_phase, 2.0 * PI) / (2.0 * PI));
-            float primarySample;
-            if (freq > CHIRP_CENTER_FREQ + deadZoneHz) {
-                // "Move down" — triangle + octave harmonic for richer timbre
-                primarySample = (4.0f * fabsf(normPhase - 0.5f) - 1.0f) * BASE_VOLUME;
-                float octavePhase = fmod(normPhase * 2.0f, 1.0f);
-                primarySample += (4.0f * fabsf(octavePhase - 0.5f) - 1.0f) * BASE_VOLUME * CHIRP_DOWN_OCTAVE_MIX;
-            } else {
-                // "Move up" and center — pure triangle
-                primarySample = (4.0f * fabsf(normPhase - 0.5f) - 1.0f) * BASE_VOLUME;
-            }
+// Pulse: high for the first `width` of the cycle, low otherwise (square = half width, +1/-1)
+static inline float osc_pulse_blep(uint32_t phase, uint32_t inc, uint32_t width, float high, float low) {
+    float naive = (phase < width) ? high : low;
+    float halfStep = (high - low) * 0.5f;
+    return naive + halfStep * (poly_blep(phase, inc) - poly_blep(phase - width, inc));
+}
 
-            // Advance primary phase with swept frequency
-            g_phase += primaryPhaseInc;
-            if (g_phase >= 2.0 * PI) g_phase -= 2.0 * PI;
+// ============================================================================
+// Block Kernels (scalar / SSE2 / AVX2, chosen by CPUID at load)
+// ============================================================================
 
-            // Apply pulse envelope with smooth attack/release ramps
-            float targetPrimaryEnvelope = 1.0f;  // Default: full on (continuous tone)
-            if (primaryPulseRate > 0.0f) {
-                targetPrimaryEnvelope = currentPulseOn ? 1.0f : 0.0f;
-            }
+// Voices render in blocks of up to SYNTH_BLOCK frames. The sample-to-sample parts of a
+// voice (envelope state machines and slews, one-pole filters, chirp decay, ramps) run in
+// a scalar pass that fills per-sample phase/gain arrays; the kernels below then do the
+// waveform, gain and mix math across the whole block. Every table computes the same
+// expressions in the same order, so outputs agree to within float rounding (see synth_bench).
+static const int SYNTH_BLOCK = 256;
+
+struct SynthKernels {
+    const char* name;
+    // out = osc_triangle(phase) * scale
+    void (*triangle)(const uint32_t* phase, float scale, float* out, int n);
+    // out = osc_triangle(phase) * scale + osc_triangle(phase << 1) * octaveScale
+    void (*triangle_octave)(const uint32_t* phase, float scale, const float* octaveScale, float* out, int n);
+    // out = osc_sine(phase) * scale
+    void (*sine)(const uint32_t* phase, float scale, float* out, int n);
+    // out = osc_saw_blep(phase, inc)
+    void (*saw_blep)(const uint32_t* phase, uint32_t inc, float* out, int n);
+    // out = osc_pulse_blep(phase, inc, width, high, low)
+    void (*pulse_blep)(const uint32_t* phase, uint32_t inc, uint32_t width, float high, float low, float* out, int n);
+    // phase[i] = start + i * inc; returns the phase after the block
+    uint32_t (*phase_ramp)(uint32_t start, uint32_t inc, uint32_t* phase, int n);
+    // out *= gain
+    void (*mul)(float* out, const float* gain, int n);
+    // out += x
+    void (*add)(const float* x, float* out, int n);
+    // Stereo gains for a pan position (-1 left .. +1 right; the near ear stays at 1)
+    void (*pan_gains)(const float* pan, float* leftGain, float* rightGain, int n);
+    // Constant-power gains: cos/sin of (pan + 1) * pi/4 (equal power everywhere)
+    void (*pan_gains_power)(const float* pan, float* leftGain, float* rightGain, int n);
+    // left += x * leftGain, right += x * rightGain
+    void (*mix)(const float* x, const float* leftGain, const float* rightGain, float* left, float* right, int n);
+    // Same with constant gains
+    void (*mix_const)(const float* x, float leftGain, float rightGain, float* left, float* right, int n);
+    // left += busLeft * gain, right += busRight * gain
+    void (*mix_bus)(const float* busLeft, const float* busRight, float gain, float* left, float* right, int n);
+    // Interleave into the device's stereo frames
+    void (*interleave)(const float* left, const float* right, float* out, int n);
+};
 
-            // Smooth envelope transition
-            if (g_primaryEnvelopeState < targetPrimaryEnvelope) {
-                g_primaryEnvelopeState += primaryAttackCoef;
-                if (g_primaryEnvelopeState > targetPrimaryEnvelope) g_primaryEnvelopeState = targetPrimaryEnvelope;
-            } else if (g_primaryEnvelopeState > targetPrimaryEnvelope) {
-                g_primaryEnvelopeState -= primaryReleaseCoef;
-                if (g_primaryEnvelopeState < targetPrimaryEnvelope) g_primaryEnvelopeState = targetPrimaryEnvelope;
-            }
+// ----------------------------------------------------------------------------
+// Scalar
+// ----------------------------------------------------------------------------
 
-            primarySample *= g_primaryEnvelopeState;
-
-            // Apply stereo panning to primary tone
-            leftSample += primarySample * leftGain;
-            rightSample += primarySample * rightGain;
-
-            // ================================================================
-            // Secondary tone (horizontal precision) - mono click in L or R ear
-            // Triangle wave with low pass filter, frequency sweeps 500-560 Hz
-            // ================================================================
-            if (secondaryActive) {
-                // Triangle wave: map phase [0, 2*PI] to triangle [-1, +1]
-                float normalizedPhase = (float)(g_clickPhase / (2.0 * PI));  // 0 to 1
-                float triangleValue = 4.0f * fabsf(normalizedPhase - 0.5f) - 1.0f;  // Triangle wave
-                float clickSample = triangleValue * CLICK_VOLUME;
-
-                // Apply one-pole low pass filter (4100 Hz cutoff)
-                g_clickLpfState += clickLpfAlpha * (clickSample - g_clickLpfState);
-                clickSample = g_clickLpfState;
-
-                // Apply pulse envelope with smooth attack/release ramps
-                float targetEnvelope = 1.0f;  // Default: full on (continuous tone)
-                if (secondaryPulseRate > 0.0f) {
-                    // Pulsing mode: target is 1 when sin > 0, else 0
-                    targetEnvelope = (sin(g_clickPulsePhase) > 0.0f) ? 1.0f : 0.0f;
-                }
+static void triangle_scalar(const uint32_t* phase, float scale, float* out, int n) {
+    for (int i = 0; i < n; i++) out[i] = osc_triangle(phase[i]) * scale;
+}
 
-                // Smooth envelope transition using attack/release
-                if (g_clickEnvelopeState < targetEnvelope) {
-                    g_clickEnvelopeState += clickAttackCoef;
-                    if (g_clickEnvelopeState > targetEnvelope) g_clickEnvelopeState = targetEnvelope;
-                } else if (g_clickEnvelopeState > targetEnvelope) {
-                    g_clickEnvelopeState -= clickReleaseCoef;
-                    if (g_clickEnvelopeState < targetEnvelope) g_clickEnvelopeState = targetEnvelope;
-                }
+static void triangle_octave_scalar(const uint32_t* phase, float scale, const float* octaveScale, float* out, int n) {
+    for (int i = 0; i < n; i++) {
+        out[i] = osc_triangle(phase[i]) * scale + osc_triangle(phase[i] << 1) * octaveScale[i];
+    }
+}
 
-                clickSample *= g_clickEnvelopeState;
+static void sine_scalar(const uint32_t* phase, float scale, float* out, int n) {
+    for (int i = 0; i < n; i++) out[i] = osc_sine(phase[i]) * scale;
+}
 
-                // Pan click based on target direction, or center when on target
-                if (panMagnitude < horizThreshold) {
-                    // On target - play in both ears (centered)
-                    leftSample += clickSample;
-                    rightSample += clickSample;
-                } else if (pan < 0.0f) {
-                    // Target is to the left - click in left ear
-                    leftSample += clickSample;
-                } else {
-                    // Target is to the right - click in right ear
-                    rightSample += clickSample;
-                }
-            }
-        }
+static void saw_blep_scalar(const uint32_t* phase, uint32_t inc, float* out, int n) {
+    for (int i = 0; i < n; i++) out[i] = osc_saw_blep(phase[i], inc);
+}
 
-        // ================================================================
-        // Vertical lock blip (one-shot notification)
-        // ================================================================
-        if (active) {
-            // Check for pending blip and start envelope if idle
-            if (g_aimBlipPending.load() && g_blipEnvState == 0) {
-                g_blipEnvState = 1;
-                g_blipEnvelope = 0.0f;
-                g_blipPhase = 0.0;
-                g_blipSustainSamples = BLIP_SUSTAIN_SAMPLES;
-                g_aimBlipPending.store(false);
-            }
+static void pulse_blep_scalar(const uint32_t* phase, uint32_t inc, uint32_t width, float high, float low, float* out, int n) {
+    for (int i = 0; i < n; i++) out[i] = osc_pulse_blep(phase[i], inc, width, high, low);
+}
 
-            if (g_blipEnvState > 0) {
-                // Generate sine wave at 800 Hz
-                float blipSample = (float)sin(g_blipPhase) * BLIP_VOLUME;
-
-                // Advance phase
-                double blipPhaseInc = (2.0 * PI * BLIP_FREQ) / SAMPLE_RATE;
-                g_blipPhase += blipPhaseInc;
-                if (g_blipPhase >= 2.0 * PI) g_blipPhase -= 2.0 * PI;
-
-                // Update envelope state machine
-                switch (g_blipEnvState) {
-                    case 1:  // Attack
-                        g_blipEnvelope += 1.0f / BLIP_ATTACK_SAMPLES;
-                        if (g_blipEnvelope >= 1.0f) {
-                            g_blipEnvelope = 1.0f;
-                            g_blipEnvState = 2;
-                        }
-                        break;
-                    case 2:  // Sustain
-                        g_blipSustainSamples--;
-                        if (g_blipSustainSamples <= 0) {
-                            g_blipEnvState = 3;
-                        }
-                        break;
-                    case 3:  // Release
-                        g_blipEnvelope -= 1.0f / BLIP_RELEASE_SAMPLES;
-                        if (g_blipEnvelope <= 0.0f) {
-                            g_blipEnvelope = 0.0f;
-                            g_blipEnvState = 0;  // Done
-                        }
-                        break;
-                }
+static uint32_t phase_ramp_scalar(uint32_t start, uint32_t inc, uint32_t* phase, int n) {
+    for (int i = 0; i < n; i++) {
+        phase[i] = start;
+        start += inc;
+    }
+    return start;
+}
 
-                // Apply envelope and add to both channels (mono)
-                blipSample *= g_blipEnvelope;
-                leftSample += blipSample;
-                rightSample += blipSample;
-            }
+static void mul_scalar(float* out, const float* gain, int n) {
+    for (int i = 0; i < n; i++) out[i] *= gain[i];
+}
 
-            // ================================================================
-            // Vertical unlock blip (one-shot notification at 500 Hz)
-            // ================================================================
-            if (g_aimUnlockBlipPending.load() && g_unlockBlipEnvState == 0) {
-                g_unlockBlipEnvState = 1;
-                g_unlockBlipEnvelope = 0.0f;
-                g_unlockBlipPhase = 0.0;
-                g_unlockBlipSustainSamples = BLIP_SUSTAIN_SAMPLES;
-                g_aimUnlockBlipPending.store(false);
-            }
+static void add_scalar(const float* x, float* out, int n) {
+    for (int i = 0; i < n; i++) out[i] += x[i];
+}
 
-            if (g_unlockBlipEnvState > 0) {
-                // Generate sine wave at 500 Hz
-                float unlockBlipSample = (float)sin(g_unlockBlipPhase) * BLIP_VOLUME;
-
-                // Advance phase
-                double unlockBlipPhaseInc = (2.0 * PI * UNLOCK_BLIP_FREQ) / SAMPLE_RATE;
-                g_unlockBlipPhase += unlockBlipPhaseInc;
-                if (g_unlockBlipPhase >= 2.0 * PI) g_unlockBlipPhase -= 2.0 * PI;
-
-                // Update envelope state machine
-                switch (g_unlockBlipEnvState) {
-                    case 1:  // Attack
-                        g_unlockBlipEnvelope += 1.0f / BLIP_ATTACK_SAMPLES;
-                        if (g_unlockBlipEnvelope >= 1.0f) {
-                            g_unlockBlipEnvelope = 1.0f;
-                            g_unlockBlipEnvState = 2;
-                        }
-                        break;
-                    case 2:  // Sustain
-                        g_unlockBlipSustainSamples--;
-                        if (g_unlockBlipSustainSamples <= 0) {
-                            g_unlockBlipEnvState = 3;
-                        }
-                        break;
-                    case 3:  // Release
-                        g_unlockBlipEnvelope -= 1.0f / BLIP_RELEASE_SAMPLES;
-                        if (g_unlockBlipEnvelope <= 0.0f) {
-                            g_unlockBlipEnvelope = 0.0f;
-                            g_unlockBlipEnvState = 0;  // Done
-                        }
-                        break;
-                }
+static void pan_gains_scalar(const float* pan, float* leftGain, float* rightGain, int n) {
+    for (int i = 0; i < n; i++) {
+        leftGain[i] = (pan[i] <= 0.0f) ? 1.0f : (1.0f - pan[i]);
+        rightGain[i] = (pan[i] >= 0.0f) ? 1.0f : (1.0f + pan[i]);
+    }
+}
 
-                // Apply envelope and add to both channels (mono)
-                unlockBlipSample *= g_unlockBlipEnvelope;
-                leftSample += unlockBlipSample;
-                rightSample += unlockBlipSample;
-            }
-        }
+// sin(x) for 0 <= x <= pi/2 (odd Taylor series to x^9, error < 4e-6)
+static inline float pan_law_sin(float x) {
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+}
 
-        // ================================================================
-        // Terrain Radar audio (can play alongside aim assist)
-        // ================================================================
-        if (g_radarActive.load()) {
-            // Check for pending beeps in queue (only when idle)
-            if (g_radarEnvState == 0) {
-                int tail = g_radarQueueTail.load(std::memory_order_relaxed);
-                int head = g_radarQueueHead.load(std::memory_order_acquire);
-
-                if (tail != head) {
-                    // Consume beep from queue
-                    g_radarPlayingPan = g_radarQueue[tail].pan;
-                    g_radarPlayingVol = g_radarQueue[tail].volume;
-                    g_radarPlayingMat = g_radarQueue[tail].material;
-
-                    // Advance tail
-                    g_radarQueueTail.store((tail + 1) % RADAR_QUEUE_SIZE, std::memory_order_release);
-
-                    // Start envelope
-                    g_radarEnvState = 1;  // Start attack phase
-                    g_radarEnvelope = 0.0f;
-                    g_radarPhase = 0.0;
-                    g_radarSustainSamples = RADAR_SUSTAIN_SAMPLES;
-                }
-            }
+// Constant-power gains for one pan position (radar beeps and the scalar kernel)
+static inline void pan_law_gains(float pan, float& leftGain, float& rightGain) {
+    static const float quarterPi = (float)(PI / 4.0);
+    pan = (pan < -1.0f) ? -1.0f : (pan > 1.0f) ? 1.0f : pan;
+    float angle = (pan + 1.0f) * quarterPi;
+    leftGain = pan_law_sin(2.0f * quarterPi - angle);
+    rightGain = pan_law_sin(angle);
+}
 
-            // Process envelope state machine
-            if (g_radarEnvState > 0) {
-                // Use playing parameters (consumed from queue at beep start)
-                float radarPan = g_radarPlayingPan;
-                float radarVol = g_radarPlayingVol;
-                int radarMat = g_radarPlayingMat;
-
-                // Select frequency based on material
-                float radarFreq;
-                switch (radarMat) {
-                    case 1: radarFreq = RADAR_FREQ_GRASS; break;
-                    case 2: radarFreq = RADAR_FREQ_CONCRETE; break;
-                    case 3: radarFreq = RADAR_FREQ_WOOD; break;
-                    case 4: radarFreq = RADAR_FREQ_METAL; break;
-                    case 5: radarFreq = RADAR_FREQ_WATER; break;
-                    case 6: radarFreq = RADAR_FREQ_MAN; break;
-                    case 7: radarFreq = RADAR_FREQ_GLASS; break;
-                    default: radarFreq = RADAR_FREQ_DEFAULT; break;
-                }
+static void pan_gains_power_scalar(const float* pan, float* leftGain, float* rightGain, int n) {
+    for (int i = 0; i < n; i++) pan_law_gains(pan[i], leftGain[i], rightGain[i]);
+}
 
-                // Generate waveform based on material
-                float radarSample = 0.0f;
-                double radarPhaseInc = (2.0 * PI * radarFreq) / SAMPLE_RATE;
+static void mix_scalar(const float* x, const float* leftGain, const float* rightGain, float* left, float* right, int n) {
+    for (int i = 0; i < n; i++) {
+        left[i] += x[i] * leftGain[i];
+        right[i] += x[i] * rightGain[i];
+    }
+}
 
-                switch (radarMat) {
-                    case 1:  // grass - sine (soft)
-                        radarSample = (float)sin(g_radarPhase);
-                        break;
-                    case 2:  // concrete - square (harsh)
-                        radarSample = (sin(g_radarPhase) > 0.0) ? 1.0f : -1.0f;
-                        break;
-                    case 3:  // wood - triangle (organic)
-                        {
-                            float normPhase = (float)(g_radarPhase / (2.0 * PI));
-                            radarSample = 4.0f * fabsf(normPhase - 0.5f) - 1.0f;
-                        }
-                        break;
-                    case 4:  // metal - sawtooth (buzzy)
-                        radarSample = (float)(2.0 * (g_radarPhase / (2.0 * PI)) - 1.0);
-                        break;
-                    case 5:  // water - filtered noise approximation (low sine with harmonics)
-                        radarSample = (float)(sin(g_radarPhase) * 0.7 + sin(g_radarPhase * 2.3) * 0.3);
-                        break;
-                    case 6:  // man - pulse (25% duty cycle, distinct alert)
-                        radarSample = (g_radarPhase < PI * 0.5) ? 1.0f : -0.3f;
-                        break;
-                    case 7:  // glass - sine + harmonic (bright)
-                        radarSample = (float)(sin(g_radarPhase) * 0.8 + sin(g_radarPhase * 2.0) * 0.2);
-                        break;
-                    default:  // default - sine
-                        radarSample = (float)sin(g_radarPhase);
-                        break;
-                }
+static void mix_const_scalar(const float* x, float leftGain, float rightGain, float* left, float* right, int n) {
+    for (int i = 0; i < n; i++) {
+        left[i] += x[i] * leftGain;
+        right[i] += x[i] * rightGain;
+    }
+}
 
-                // Update envelope
-                switch (g_radarEnvState) {
-                    case 1:  // Attack
-                        g_radarEnvelope += 1.0f / RADAR_ATTACK_SAMPLES;
-                        if (g_radarEnvelope >= 1.0f) {
-                            g_radarEnvelope = 1.0f;
-                            g_radarEnvState = 2;  // Move to sustain
-                        }
-                        break;
-                    case 2:  // Sustain
-                        g_radarSustainSamples--;
-                        if (g_radarSustainSamples <= 0) {
-                            g_radarEnvState = 3;  // Move to release
-                        }
-                        break;
-                    case 3:  // Release
-                        g_radarEnvelope -= 1.0f / RADAR_RELEASE_SAMPLES;
-                        if (g_radarEnvelope <= 0.0f) {
-                            g_radarEnvelope = 0.0f;
-                            g_radarEnvState = 0;  // Done
-                        }
-                        break;
-                }
+static void mix_bus_scalar(const float* busLeft, const float* busRight, float gain, float* left, float* right, int n) {
+    for (int i = 0; i < n; i++) {
+        left[i] += busLeft[i] * gain;
+        right[i] += busRight[i] * gain;
+    }
+}
 
-                // Apply volume and envelope
-                radarSample *= g_radarEnvelope * radarVol * RADAR_BASE_VOLUME;
+static void interleave_scalar(const float* left, const float* right, float* out, int n) {
+    for (int i = 0; i < n; i++) {
+        out[2 * i] = left[i];
+        out[2 * i + 1] = right[i];
+    }
+}
 
-                // Apply stereo panning
-                float radarLeftGain = (radarPan <= 0.0f) ? 1.0f : (1.0f - radarPan);
-                float radarRightGain = (radarPan >= 0.0f) ? 1.0f : (1.0f + radarPan);
+static const SynthKernels SYNTH_SCALAR = {
+    "scalar", triangle_scalar, triangle_octave_scalar, sine_scalar, saw_blep_scalar, pulse_blep_scalar,
+    phase_ramp_scalar, mul_scalar, add_scalar, pan_gains_scalar, pan_gains_power_scalar, mix_scalar, mix_const_scalar,
+    mix_bus_scalar, interleave_scalar
+};
 
-                leftSample += radarSample * radarLeftGain;
-                rightSample += radarSample * radarRightGain;
+// ----------------------------------------------------------------------------
+// SSE2 (4 lanes; the tail of each block falls back to the scalar loop)
+// ----------------------------------------------------------------------------
 
-                // Advance radar phase
-                g_radarPhase += radarPhaseInc;
-                if (g_radarPhase >= 2.0 * PI) g_radarPhase -= 2.0 * PI;
-            }
-        }
+// Unsigned a < b (SSE2 only has signed compares: flip the sign bits first)
+static inline __m128i sse2_lt_u32(__m128i a, __m128i b) {
+    const __m128i bias = _mm_set1_epi32((int)0x80000000u);
+    return _mm_cmplt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
 
-        // ================================================================
-        // Navigation Beacon audio (can play alongside aim assist)
-        // Triangle wave with frequency sweep, pulsing, and LPF
-        // ================================================================
-        if (g_beaconActive.load()) {
-            float beaconPan = g_beaconPan.load();
+static inline __m128 sse2_select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
 
-            // Calculate pan magnitude and centeredness (0 = far, 1 = centered)
-            float panMagnitude = fabsf(beaconPan);
-            float centeredness = 1.0f - (panMagnitude / 0.2f);  // 0.2 = max useful range
-            centeredness = (centeredness < 0.0f) ? 0.0f : (centeredness > 1.0f) ? 1.0f : centeredness;
+static inline __m128 sse2_triangle(__m128i phase) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(phase, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+    __m128 folded = _mm_and_ps(_mm_sub_ps(unit, _mm_set1_ps(0.5f)), absMask);
+    return _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(4.0f), folded), _mm_set1_ps(1.0f));
+}
 
-            // Frequency sweep: 400 Hz (off center) to 460 Hz (centered)
-            float beaconFreq = BEACON_FREQ_MIN + centeredness * (BEACON_FREQ_MAX - BEACON_FREQ_MIN);
+static inline __m128 sse2_sine(__m128i phase) {
+    const int fracBits = 32 - SINE_TABLE_BITS;
+    alignas(16) int index[4];
+    _mm_store_si128((__m128i*)index, _mm_srli_epi32(phase, fracBits));
+    __m128 a = _mm_setr_ps(g_sineTable[index[0]], g_sineTable[index[1]], g_sineTable[index[2]], g_sineTable[index[3]]);
+    __m128 b = _mm_setr_ps(g_sineTable[index[0] + 1], g_sineTable[index[1] + 1], g_sineTable[index[2] + 1], g_sineTable[index[3] + 1]);
+    __m128i fracBitsMask = _mm_set1_epi32((1 << fracBits) - 1);
+    __m128 frac = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(phase, fracBitsMask)), _mm_set1_ps(1.0f / (float)(1 << fracBits)));
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), frac));
+}
 
-            // Advance oscillator phase with current frequency
-            double beaconPhaseInc = (2.0 * PI * beaconFreq) / SAMPLE_RATE;
-            g_beaconPhase += beaconPhaseInc;
-            if (g_beaconPhase >= 2.0 * PI) g_beaconPhase -= 2.0 * PI;
+// poly_blep: t = phase / inc as a signed fraction of the step, nonzero within one inc of the jump
+static inline __m128 sse2_poly_blep(__m128i phase, __m128i inc, __m128 incf) {
+    __m128 t = _mm_div_ps(_mm_cvtepi32_ps(phase), incf);
+    __m128 tt = _mm_mul_ps(t, t);
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 after = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(t, t), tt), one);     // 0 <= t < 1
+    __m128 before = _mm_add_ps(_mm_add_ps(_mm_add_ps(tt, t), t), one);    // -1 < t < 0
+    __m128 afterMask = _mm_castsi128_ps(sse2_lt_u32(phase, inc));
+    __m128 beforeMask = _mm_castsi128_ps(sse2_lt_u32(_mm_sub_epi32(_mm_setzero_si128(), inc), phase));
+    return _mm_or_ps(_mm_and_ps(afterMask, after), _mm_and_ps(beforeMask, before));
+}
 
-            // Generate triangle wave: map phase [0, 2*PI] to triangle [-1, +1]
-            float normalizedPhase = (float)(g_beaconPhase / (2.0 * PI));  // 0 to 1
-            float triangleSample = 4.0f * fabsf(normalizedPhase - 0.5f) - 1.0f;
+static void triangle_sse2(const uint32_t* phase, float scale, float* out, int n) {
+    __m128 vscale = _mm_set1_ps(scale);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(phase + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(sse2_triangle(p), vscale));
+    }
+    triangle_scalar(phase + i, scale, out + i, n - i);
+}
 
-            // Apply one-pole low pass filter (4000 Hz cutoff)
-            static const float beaconLpfAlpha = 1.0f - expf(-2.0f * (float)PI * BEACON_LPF_CUTOFF / SAMPLE_RATE);
-            g_beaconLpfState += beaconLpfAlpha * (triangleSample - g_beaconLpfState);
+static void triangle_octave_sse2(const uint32_t* phase, float scale, const float* octaveScale, float* out, int n) {
+    __m128 vscale = _mm_set1_ps(scale);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(phase + i));
+        __m128 fundamental = _mm_mul_ps(sse2_triangle(p), vscale);
+        __m128 octave = _mm_mul_ps(sse2_triangle(_mm_slli_epi32(p, 1)), _mm_loadu_ps(octaveScale + i));
+        _mm_storeu_ps(out + i, _mm_add_ps(fundamental, octave));
+    }
+    triangle_octave_scalar(phase + i, scale, octaveScale + i, out + i, n - i);
+}
 
-            // Calculate pulse rate based on pan magnitude
-            float beaconPulseRate = 0.0f;  // 0 = continuous
-            if (panMagnitude >= BEACON_CENTER_THRESHOLD) {
-                // Map pan [0.05, 0.2+] to pulse rate [15 Hz, 2 Hz]
-                float t = (panMagnitude - BEACON_CENTER_THRESHOLD) / (0.2f - BEACON_CENTER_THRESHOLD);
-                t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;
-                beaconPulseRate = BEACON_MAX_PULSE_RATE + t * (BEACON_MIN_PULSE_RATE - BEACON_MAX_PULSE_RATE);
-            }
+static void sine_sse2(const uint32_t* phase, float scale, float* out, int n) {
+    __m128 vscale = _mm_set1_ps(scale);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)(phase + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(sse2_sine(p), vscale));
+    }
+    sine_scalar(phase + i, scale, out + i, n - i);
+}
 
-            // Calculate pulse envelope (square wave envelope for on/off)
-            float targetEnvelope = 1.0f;
-            if (beaconPulseRate > 0.0f) {
-                double beaconPulseInc = (2.0 * PI * beaconPulseRate) / SAMPLE_RATE;
-                g_beaconPulsePhase += beaconPulseInc;
-                if (g_beaconPulsePhase >= 2.0 * PI) g_beaconPulsePhase -= 2.0 * PI;
-                targetEnvelope = (sin(g_beaconPulsePhase) > 0.0) ? 1.0f : 0.0f;
-            } else {
-                g_beaconPulsePhase = 0.0;  // Reset when continuous
-            }
+static void saw_blep_sse2(const uint32_t* phase, uint32_t inc, float* out, int n) {
+    __m128i vinc = _mm_set1_epi32((int)inc);
+    __m128 incf = _mm_set1_ps((float)inc);
+    int i = 0;
+    if (inc != 0) {
+        for (; i + 4 <= n; i += 4) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(phase + i));
+            __m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(p, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+            __m128 saw = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.0f), unit), _mm_set1_ps(1.0f));
+            _mm_storeu_ps(out + i, _mm_sub_ps(saw, sse2_poly_blep(p, vinc, incf)));
+        }
+    }
+    saw_blep_scalar(phase + i, inc, out + i, n - i);
+}
+
+static void pulse_blep_sse2(const uint32_t* phase, uint32_t inc, uint32_t width, float high, float low, float* out, int n) {
+    __m128i vinc = _mm_set1_epi32((int)inc);
+    __m128i vwidth = _mm_set1_epi32((int)width);
+    __m128 incf = _mm_set1_ps((float)inc);
+    __m128 vhigh = _mm_set1_ps(high);
+    __m128 vlow = _mm_set1_ps(low);
+    __m128 halfStep = _mm_set1_ps((high - low) * 0.5f);
+    int i = 0;
+    if (inc != 0) {
+        for (; i + 4 <= n; i += 4) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(phase + i));
+            __m128 naive = sse2_select(_mm_castsi128_ps(sse2_lt_u32(p, vwidth)), vhigh, vlow);
+            __m128 residual = _mm_sub_ps(sse2_poly_blep(p, vinc, incf), sse2_poly_blep(_mm_sub_epi32(p, vwidth), vinc, incf));
+            _mm_storeu_ps(out + i, _mm_add_ps(naive, _mm_mul_ps(halfStep, residual)));
+        }
+    }
+    pulse_blep_scalar(phase + i, inc, width, high, low, out + i, n - i);
+}
+
+static uint32_t phase_ramp_sse2(uint32_t start, uint32_t inc, uint32_t* phase, int n) {
+    __m128i p = _mm_add_epi32(_mm_set1_epi32((int)start), _mm_setr_epi32(0, (int)inc, (int)(inc * 2), (int)(inc * 3)));
+    __m128i step = _mm_set1_epi32((int)(inc * 4));
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_si128((__m128i*)(phase + i), p);
+        p = _mm_add_epi32(p, step);
+    }
+    return phase_ramp_scalar(start + inc * (uint32_t)i, inc, phase + i, n - i);
+}
+
+static void mul_sse2(float* out, const float* gain, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(out + i), _mm_loadu_ps(gain + i)));
+    }
+    mul_scalar(out + i, gain + i, n - i);
+}
+
+static void add_sse2(const float* x, float* out, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_loadu_ps(x + i)));
+    }
+    add_scalar(x + i, out + i, n - i);
+}
+
+// (pan <= 0 ? 1 : 1 - pan) == min(1, 1 - pan), and likewise for the right ear
+static void pan_gains_sse2(const float* pan, float* leftGain, float* rightGain, int n) {
+    __m128 one = _mm_set1_ps(1.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 p = _mm_loadu_ps(pan + i);
+        _mm_storeu_ps(leftGain + i, _mm_min_ps(one, _mm_sub_ps(one, p)));
+        _mm_storeu_ps(rightGain + i, _mm_min_ps(one, _mm_add_ps(one, p)));
+    }
+    pan_gains_scalar(pan + i, leftGain + i, rightGain + i, n - i);
+}
+
+static inline __m128 sse2_pan_law_sin(__m128 x) {
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_add_ps(_mm_set1_ps(-1.0f / 5040.0f), _mm_mul_ps(x2, _mm_set1_ps(1.0f / 362880.0f)));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 120.0f), _mm_mul_ps(x2, p));
+    p = _mm_add_ps(_mm_set1_ps(-1.0f / 6.0f), _mm_mul_ps(x2, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, p));
+    return _mm_mul_ps(x, p);
+}
+
+static void pan_gains_power_sse2(const float* pan, float* leftGain, float* rightGain, int n) {
+    const float quarterPi = (float)(PI / 4.0);
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 q = _mm_set1_ps(quarterPi);
+    __m128 halfPi = _mm_set1_ps(2.0f * quarterPi);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 p = _mm_min_ps(one, _mm_max_ps(_mm_set1_ps(-1.0f), _mm_loadu_ps(pan + i)));
+        __m128 angle = _mm_mul_ps(_mm_add_ps(p, one), q);
+        _mm_storeu_ps(leftGain + i, sse2_pan_law_sin(_mm_sub_ps(halfPi, angle)));
+        _mm_storeu_ps(rightGain + i, sse2_pan_law_sin(angle));
+    }
+    pan_gains_power_scalar(pan + i, leftGain + i, rightGain + i, n - i);
+}
+
+static void mix_sse2(const float* x, const float* leftGain, const float* rightGain, float* left, float* right, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        _mm_storeu_ps(left + i, _mm_add_ps(_mm_loadu_ps(left + i), _mm_mul_ps(v, _mm_loadu_ps(leftGain + i))));
+        _mm_storeu_ps(right + i, _mm_add_ps(_mm_loadu_ps(right + i), _mm_mul_ps(v, _mm_loadu_ps(rightGain + i))));
+    }
+    mix_scalar(x + i, leftGain + i, rightGain + i, left + i, right + i, n - i);
+}
+
+static void mix_const_sse2(const float* x, float leftGain, float rightGain, float* left, float* right, int n) {
+    __m128 gl = _mm_set1_ps(leftGain);
+    __m128 gr = _mm_set1_ps(rightGain);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        _mm_storeu_ps(left + i, _mm_add_ps(_mm_loadu_ps(left + i), _mm_mul_ps(v, gl)));
+        _mm_storeu_ps(right + i, _mm_add_ps(_mm_loadu_ps(right + i), _mm_mul_ps(v, gr)));
+    }
+    mix_const_scalar(x + i, leftGain, rightGain, left + i, right + i, n - i);
+}
+
+static void mix_bus_sse2(const float* busLeft, const float* busRight, float gain, float* left, float* right, int n) {
+    __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(left + i, _mm_add_ps(_mm_loadu_ps(left + i), _mm_mul_ps(_mm_loadu_ps(busLeft + i), g)));
+        _mm_storeu_ps(right + i, _mm_add_ps(_mm_loadu_ps(right + i), _mm_mul_ps(_mm_loadu_ps(busRight + i), g)));
+    }
+    mix_bus_scalar(busLeft + i, busRight + i, gain, left + i, right + i, n - i);
+}
+
+static void interleave_sse2(const float* left, const float* right, float* out, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+    interleave_scalar(left + i, right + i, out + 2 * i, n - i);
+}
+
+static const SynthKernels SYNTH_SSE2 = {
+    "sse2", triangle_sse2, triangle_octave_sse2, sine_sse2, saw_blep_sse2, pulse_blep_sse2,
+    phase_ramp_sse2, mul_sse2, add_sse2, pan_gains_sse2, pan_gains_power_sse2, mix_sse2, mix_const_sse2,
+    mix_bus_sse2, interleave_sse2
+};
+
+// ----------------------------------------------------------------------------
+// AVX2 (8 lanes; table sine uses gathers). MSVC compiles AVX2 intrinsics without
+// /arch:AVX2; GCC/Clang need the target attribute on each function that uses them.
+// ----------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SYNTH_AVX2 __attribute__((target("avx2")))
+#else
+#define SYNTH_AVX2
+#endif
+
+SYNTH_AVX2 static inline __m256i avx2_lt_u32(__m256i a, __m256i b) {
+    const __m256i bias = _mm256_set1_epi32((int)0x80000000u);
+    return _mm256_cmpgt_epi32(_mm256_xor_si256(b, bias), _mm256_xor_si256(a, bias));
+}
+
+SYNTH_AVX2 static inline __m256 avx2_triangle(__m256i phase) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 unit = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(phase, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+    __m256 folded = _mm256_and_ps(_mm256_sub_ps(unit, _mm256_set1_ps(0.5f)), absMask);
+    return _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), folded), _mm256_set1_ps(1.0f));
+}
+
+SYNTH_AVX2 static inline __m256 avx2_sine(__m256i phase) {
+    const int fracBits = 32 - SINE_TABLE_BITS;
+    __m256i index = _mm256_srli_epi32(phase, fracBits);
+    __m256 a = _mm256_i32gather_ps(g_sineTable, index, 4);
+    __m256 b = _mm256_i32gather_ps(g_sineTable + 1, index, 4);
+    __m256i fracBitsMask = _mm256_set1_epi32((1 << fracBits) - 1);
+    __m256 frac = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(phase, fracBitsMask)), _mm256_set1_ps(1.0f / (float)(1 << fracBits)));
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), frac));
+}
+
+SYNTH_AVX2 static inline __m256 avx2_poly_blep(__m256i phase, __m256i inc, __m256 incf) {
+    __m256 t = _mm256_div_ps(_mm256_cvtepi32_ps(phase), incf);
+    __m256 tt = _mm256_mul_ps(t, t);
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 after = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(t, t), tt), one);
+    __m256 before = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(tt, t), t), one);
+    __m256 afterMask = _mm256_castsi256_ps(avx2_lt_u32(phase, inc));
+    __m256 beforeMask = _mm256_castsi256_ps(avx2_lt_u32(_mm256_sub_epi32(_mm256_setzero_si256(), inc), phase));
+    return _mm256_or_ps(_mm256_and_ps(afterMask, after), _mm256_and_ps(beforeMask, before));
+}
+
+SYNTH_AVX2 static void triangle_avx2(const uint32_t* phase, float scale, float* out, int n) {
+    __m256 vscale = _mm256_set1_ps(scale);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i*)(phase + i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(avx2_triangle(p), vscale));
+    }
+    triangle_scalar(phase + i, scale, out + i, n - i);
+}
+
+SYNTH_AVX2 static void triangle_octave_avx2(const uint32_t* phase, float scale, const float* octaveScale, float* out, int n) {
+    __m256 vscale = _mm256_set1_ps(scale);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i*)(phase + i));
+        __m256 fundamental = _mm256_mul_ps(avx2_triangle(p), vscale);
+        __m256 octave = _mm256_mul_ps(avx2_triangle(_mm256_slli_epi32(p, 1)), _mm256_loadu_ps(octaveScale + i));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(fundamental, octave));
+    }
+    triangle_octave_scalar(phase + i, scale, octaveScale + i, out + i, n - i);
+}
+
+SYNTH_AVX2 static void sine_avx2(const uint32_t* phase, float scale, float* out, int n) {
+    __m256 vscale = _mm256_set1_ps(scale);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i*)(phase + i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(avx2_sine(p), vscale));
+    }
+    sine_scalar(phase + i, scale, out + i, n - i);
+}
+
+SYNTH_AVX2 static void saw_blep_avx2(const uint32_t* phase, uint32_t inc, float* out, int n) {
+    __m256i vinc = _mm256_set1_epi32((int)inc);
+    __m256 incf = _mm256_set1_ps((float)inc);
+    int i = 0;
+    if (inc != 0) {
+        for (; i + 8 <= n; i += 8) {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(phase + i));
+            __m256 unit = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(p, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+            __m256 saw = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), unit), _mm256_set1_ps(1.0f));
+            _mm256_storeu_ps(out + i, _mm256_sub_ps(saw, avx2_poly_blep(p, vinc, incf)));
+        }
+    }
+    saw_blep_scalar(phase + i, inc, out + i, n - i);
+}
+
+SYNTH_AVX2 static void pulse_blep_avx2(const uint32_t* phase, uint32_t inc, uint32_t width, float high, float low, float* out, int n) {
+    __m256i vinc = _mm256_set1_epi32((int)inc);
+    __m256i vwidth = _mm256_set1_epi32((int)width);
+    __m256 incf = _mm256_set1_ps((float)inc);
+    __m256 vhigh = _mm256_set1_ps(high);
+    __m256 vlow = _mm256_set1_ps(low);
+    __m256 halfStep = _mm256_set1_ps((high - low) * 0.5f);
+    int i = 0;
+    if (inc != 0) {
+        for (; i + 8 <= n; i += 8) {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(phase + i));
+            __m256 naive = _mm256_blendv_ps(vlow, vhigh, _mm256_castsi256_ps(avx2_lt_u32(p, vwidth)));
+            __m256 residual = _mm256_sub_ps(avx2_poly_blep(p, vinc, incf), avx2_poly_blep(_mm256_sub_epi32(p, vwidth), vinc, incf));
+            _mm256_storeu_ps(out + i, _mm256_add_ps(naive, _mm256_mul_ps(halfStep, residual)));
+        }
+    }
+    pulse_blep_scalar(phase + i, inc, width, high, low, out + i, n - i);
+}
+
+SYNTH_AVX2 static uint32_t phase_ramp_avx2(uint32_t start, uint32_t inc, uint32_t* phase, int n) {
+    __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int)inc));
+    __m256i p = _mm256_add_epi32(_mm256_set1_epi32((int)start), lanes);
+    __m256i step = _mm256_set1_epi32((int)(inc * 8));
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_si256((__m256i*)(phase + i), p);
+        p = _mm256_add_epi32(p, step);
+    }
+    return phase_ramp_scalar(start + inc * (uint32_t)i, inc, phase + i, n - i);
+}
+
+SYNTH_AVX2 static void mul_avx2(float* out, const float* gain, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(out + i), _mm256_loadu_ps(gain + i)));
+    }
+    mul_scalar(out + i, gain + i, n - i);
+}
+
+SYNTH_AVX2 static void add_avx2(const float* x, float* out, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_loadu_ps(x + i)));
+    }
+    add_scalar(x + i, out + i, n - i);
+}
+
+SYNTH_AVX2 static void pan_gains_avx2(const float* pan, float* leftGain, float* rightGain, int n) {
+    __m256 one = _mm256_set1_ps(1.0f);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_loadu_ps(pan + i);
+        _mm256_storeu_ps(leftGain + i, _mm256_min_ps(one, _mm256_sub_ps(one, p)));
+        _mm256_storeu_ps(rightGain + i, _mm256_min_ps(one, _mm256_add_ps(one, p)));
+    }
+    pan_gains_scalar(pan + i, leftGain + i, rightGain + i, n - i);
+}
+
+SYNTH_AVX2 static inline __m256 avx2_pan_law_sin(__m256 x) {
+    __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 p = _mm256_add_ps(_mm256_set1_ps(-1.0f / 5040.0f), _mm256_mul_ps(x2, _mm256_set1_ps(1.0f / 362880.0f)));
+    p = _mm256_add_ps(_mm256_set1_ps(1.0f / 120.0f), _mm256_mul_ps(x2, p));
+    p = _mm256_add_ps(_mm256_set1_ps(-1.0f / 6.0f), _mm256_mul_ps(x2, p));
+    p = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(x2, p));
+    return _mm256_mul_ps(x, p);
+}
+
+SYNTH_AVX2 static void pan_gains_power_avx2(const float* pan, float* leftGain, float* rightGain, int n) {
+    const float quarterPi = (float)(PI / 4.0);
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 q = _mm256_set1_ps(quarterPi);
+    __m256 halfPi = _mm256_set1_ps(2.0f * quarterPi);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_min_ps(one, _mm256_max_ps(_mm256_set1_ps(-1.0f), _mm256_loadu_ps(pan + i)));
+        __m256 angle = _mm256_mul_ps(_mm256_add_ps(p, one), q);
+        _mm256_storeu_ps(leftGain + i, avx2_pan_law_sin(_mm256_sub_ps(halfPi, angle)));
+        _mm256_storeu_ps(rightGain + i, avx2_pan_law_sin(angle));
+    }
+    pan_gains_power_scalar(pan + i, leftGain + i, rightGain + i, n - i);
+}
+
+SYNTH_AVX2 static void mix_avx2(const float* x, const float* leftGain, const float* rightGain, float* left, float* right, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        _mm256_storeu_ps(left + i, _mm256_add_ps(_mm256_loadu_ps(left + i), _mm256_mul_ps(v, _mm256_loadu_ps(leftGain + i))));
+        _mm256_storeu_ps(right + i, _mm256_add_ps(_mm256_loadu_ps(right + i), _mm256_mul_ps(v, _mm256_loadu_ps(rightGain + i))));
+    }
+    mix_scalar(x + i, leftGain + i, rightGain + i, left + i, right + i, n - i);
+}
+
+SYNTH_AVX2 static void mix_const_avx2(const float* x, float leftGain, float rightGain, float* left, float* right, int n) {
+    __m256 gl = _mm256_set1_ps(leftGain);
+    __m256 gr = _mm256_set1_ps(rightGain);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        _mm256_storeu_ps(left + i, _mm256_add_ps(_mm256_loadu_ps(left + i), _mm256_mul_ps(v, gl)));
+        _mm256_storeu_ps(right + i, _mm256_add_ps(_mm256_loadu_ps(right + i), _mm256_mul_ps(v, gr)));
+    }
+    mix_const_scalar(x + i, leftGain, rightGain, left + i, right + i, n - i);
+}
+
+SYNTH_AVX2 static void mix_bus_avx2(const float* busLeft, const float* busRight, float gain, float* left, float* right, int n) {
+    __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(left + i, _mm256_add_ps(_mm256_loadu_ps(left + i), _mm256_mul_ps(_mm256_loadu_ps(busLeft + i), g)));
+        _mm256_storeu_ps(right + i, _mm256_add_ps(_mm256_loadu_ps(right + i), _mm256_mul_ps(_mm256_loadu_ps(busRight + i), g)));
+    }
+    mix_bus_scalar(busLeft + i, busRight + i, gain, left + i, right + i, n - i);
+}
+
+SYNTH_AVX2 static void interleave_avx2(const float* left, const float* right, float* out, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i);
+        __m256 r = _mm256_loadu_ps(right + i);
+        __m256 lo = _mm256_unpacklo_ps(l, r);  // frames 0,1 | 4,5
+        __m256 hi = _mm256_unpackhi_ps(l, r);  // frames 2,3 | 6,7
+        _mm256_storeu_ps(out + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(out + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    interleave_scalar(left + i, right + i, out + 2 * i, n - i);
+}
+
+static const SynthKernels SYNTH_AVX2_KERNELS = {
+    "avx2", triangle_avx2, triangle_octave_avx2, sine_avx2, saw_blep_avx2, pulse_blep_avx2,
+    phase_ramp_avx2, mul_avx2, add_avx2, pan_gains_avx2, pan_gains_power_avx2, mix_avx2, mix_const_avx2,
+    mix_bus_avx2, interleave_avx2
+};
+
+// ----------------------------------------------------------------------------
+// CPU detection
+// ----------------------------------------------------------------------------
+
+static bool cpu_has_sse2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+// AVX2 also needs the OS to save YMM registers across context switches (OSXSAVE + XCR0)
+static bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// Kernel tables this CPU can run, fastest last
+static int supported_synth_kernels(const SynthKernels** tables) {
+    int count = 0;
+    tables[count++] = &SYNTH_SCALAR;
+    if (cpu_has_sse2()) tables[count++] = &SYNTH_SSE2;
+    if (cpu_has_avx2()) tables[count++] = &SYNTH_AVX2_KERNELS;
+    return count;
+}
+
+static const SynthKernels* select_synth_kernels() {
+    const SynthKernels* tables[3];
+    int count = supported_synth_kernels(tables);
+#ifdef BRIDGE_OFFLINE
+    // Golden renders pin the ISA (SIMD kernels differ from scalar in the last bits)
+    const char* isa = getenv("BRIDGE_SYNTH_ISA");
+    for (int i = 0; isa && i < count; i++) {
+        if (strcmp(isa, tables[i]->name) == 0) return tables[i];
+    }
+#endif
+    return tables[count - 1];
+}
+static const SynthKernels* const g_synth = select_synth_kernels();
+
+// Stereo gains for a block of pan positions under the selected pan law
+static void pan_law_block(const SynthKernels& k, const float* pan, float* leftGain, float* rightGain, int n) {
+    if (g_panLaw.load(std::memory_order_relaxed) == PAN_LAW_LINEAR) {
+        k.pan_gains(pan, leftGain, rightGain, n);
+    } else {
+        k.pan_gains_power(pan, leftGain, rightGain, n);
+    }
+}
+
+// Derive the pan-dependent parts of the aim voice
+static void compute_aim_pan_shape(float pan, float horizThreshold, bool horizEnabled, AimPanShape& shape) {
+    // Calculate secondary click pulse rate based on pan magnitude (distance from center)
+    // Only active when roughly facing target (abs(pan) < 0.2)
+    // Clicks speed up as you approach target, then go smooth when on target
+    float panMagnitude = fabsf(pan);
+    shape.panMagnitude = panMagnitude;
+    shape.secondaryActive = horizEnabled && (panMagnitude < HORIZ_ACTIVATE_THRESHOLD);
+    shape.secondaryPulseRate = 0.0f;
+    if (shape.secondaryActive && panMagnitude >= horizThreshold) {
+        // Map pan from [horizThreshold, HORIZ_ACTIVATE_THRESHOLD] to [MAX_PULSE_RATE, MIN_PULSE_RATE]
+        // Near target = fast clicks, near edge of activation = slow clicks
+        float t = (panMagnitude - horizThreshold) / (HORIZ_ACTIVATE_THRESHOLD - horizThreshold);
+        t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;  // Clamp to [0,1]
+        shape.secondaryPulseRate = MAX_PULSE_RATE + t * (MIN_PULSE_RATE - MAX_PULSE_RATE);
+    }
+    // When panMagnitude < horizThreshold (on target), pulseRate stays 0 = continuous smooth tone
+
+    // Calculate click frequency: sweep from 500 Hz (at threshold) to 560 Hz (at center)
+    // Uses HORIZ_ACTIVATE_THRESHOLD so it auto-scales if threshold changes
+    float clickFreq = CLICK_FREQ_MAX;  // Default to center frequency
+    if (shape.secondaryActive) {
+        // Map pan from [0, threshold] to frequency [560, 500]
+        float t = panMagnitude / HORIZ_ACTIVATE_THRESHOLD;  // 0 at center, 1 at threshold
+        clickFreq = CLICK_FREQ_MAX + t * (CLICK_FREQ_MIN - CLICK_FREQ_MAX);
+    }
+
+    shape.clickPhaseInc = phase_inc(clickFreq);
+    shape.clickPulseInc = phase_inc(shape.secondaryPulseRate);
+}
+
+// ============================================================================
+// Binaural Spatialization (audio thread)
+// ============================================================================
+
+// Spherical-head model (Brown & Duda): each ear gets its own arrival delay (ITD, the
+// Woodworth formula), a first-order head-shadow shelf that cuts highs on the far side and
+// lifts them on the near side, plus a broadband level drop (ILD). A five-echo pinna filter
+// with azimuth/elevation dependent delays adds the spectral notches that tell front from
+// back and up from down. Selected per voice with spatial:voice,binaural; the default
+// "pan" mode keeps the original stereo pan law (SpatialMode, g_spatialMode).
+
+static const float HEAD_RADIUS = 0.0875f;          // Meters
+static const float SPEED_OF_SOUND = 343.0f;        // Meters per second
+static const float BINAURAL_ILD_DB = 6.0f;         // Broadband far-ear drop at 90 degrees
+static const float BINAURAL_PAN_AZIMUTH = 90.0f;   // Pan +-1 without a direction = +-90 degrees
+static const float SHADOW_ALPHA_MIN = 0.1f;        // Head shadow at its deepest (-20 dB highs)
+static const float SHADOW_THETA_MIN = 150.0f;      // Incidence angle of the deepest shadow
+static const int BINAURAL_DELAY_SIZE = 128;        // Power of 2, > max ITD + pinna delay at 96 kHz
+
+// Pinna echoes: reflection, delay = A * cos(az/2) * sin(D * (90 - el)) + B samples at 44.1kHz
+static const int PINNA_ECHOES = 5;
+static const float PINNA_RHO[PINNA_ECHOES] = { 0.5f, -1.0f, 0.5f, -0.25f, 0.25f };
+static const float PINNA_A[PINNA_ECHOES] = { 1.0f, 5.0f, 5.0f, 5.0f, 5.0f };
+static const float PINNA_B[PINNA_ECHOES] = { 2.0f, 4.0f, 7.0f, 11.0f, 13.0f };
+static const float PINNA_D[PINNA_ECHOES] = { 1.0f, 0.5f, 0.5f, 0.5f, 0.5f };
+
+// Filter settings for one direction (0 = left ear, 1 = right ear)
+struct BinauralShape {
+    float delay[2];                // Arrival delay in samples (the nearer ear is 0)
+    float gain[2];                 // Broadband level
+    float b0[2], b1[2], a1[2];     // Head shadow shelf
+    float echoDelay[PINNA_ECHOES]; // Pinna echo delays in samples
+};
+
+// Read a ring buffer `delay` samples behind the write position (linear interpolation)
+static inline float binaural_tap(const float* ring, int writePos, float delay) {
+    int whole = (int)delay;
+    float frac = delay - (float)whole;
+    float a = ring[(writePos - whole) & (BINAURAL_DELAY_SIZE - 1)];
+    float b = ring[(writePos - whole - 1) & (BINAURAL_DELAY_SIZE - 1)];
+    return a + (b - a) * frac;
+}
+
+// Direction -> filter settings. Azimuth in degrees (0 ahead, +90 right, +-180 behind),
+// elevation in degrees (+90 overhead).
+static void compute_binaural_shape(float azimuthDeg, float elevationDeg, BinauralShape& shape) {
+    static const float degToRad = (float)PI / 180.0f;
+    static const float shadowPole = 2.0f * SPEED_OF_SOUND / HEAD_RADIUS;        // rad/s
+    const float headDelay = HEAD_RADIUS / SPEED_OF_SOUND * g_sampleRate;        // a/c in samples
+    const float bilinear = 2.0f * g_sampleRate;
+    const float sampleScale = g_sampleRate / 44100.0f;
+
+    azimuthDeg -= 360.0f * floorf((azimuthDeg + 180.0f) / 360.0f);  // -180..180
+    elevationDeg = (elevationDeg < -90.0f) ? -90.0f : (elevationDeg > 90.0f) ? 90.0f : elevationDeg;
+    float az = azimuthDeg * degToRad;
+    float el = elevationDeg * degToRad;
+    float lateral = sinf(az) * cosf(el);  // Cosine of the angle to the right ear axis
+    lateral = (lateral < -1.0f) ? -1.0f : (lateral > 1.0f) ? 1.0f : lateral;
+
+    for (int ear = 0; ear < 2; ear++) {
+        // Angle between the source and this ear's axis (0 = straight into the ear)
+        float incidence = acosf((ear == 1) ? lateral : -lateral);
+
+        // Path around the head: straight to a lit ear, plus the arc to a shadowed one
+        shape.delay[ear] = (incidence < 0.5f * (float)PI)
+            ? headDelay * (1.0f - cosf(incidence))
+            : headDelay * (1.0f + incidence - 0.5f * (float)PI);
+
+        // Shelf (alpha*s + beta) / (s + beta): alpha 2 at the ear, SHADOW_ALPHA_MIN behind the head
+        float alpha = (1.0f + SHADOW_ALPHA_MIN * 0.5f) +
+                      (1.0f - SHADOW_ALPHA_MIN * 0.5f) * cosf(incidence * (180.0f / SHADOW_THETA_MIN));
+        float norm = 1.0f / (bilinear + shadowPole);
+        shape.b0[ear] = (bilinear * alpha + shadowPole) * norm;
+        shape.b1[ear] = (shadowPole - bilinear * alpha) * norm;
+        shape.a1[ear] = (shadowPole - bilinear) * norm;
+
+        // Broadband ILD grows with how far the source sits on the other side
+        float farSide = (ear == 1) ? -lateral : lateral;
+        shape.gain[ear] = (farSide > 0.0f) ? powf(10.0f, -BINAURAL_ILD_DB * farSide / 20.0f) : 1.0f;
+    }
+    float nearest = std::min(shape.delay[0], shape.delay[1]);
+    shape.delay[0] -= nearest;
+    shape.delay[1] -= nearest;
+
+    float frontness = cosf(0.5f * az);  // 1 ahead, 0 behind
+    for (int e = 0; e < PINNA_ECHOES; e++) {
+        float echo = PINNA_A[e] * frontness * sinf(PINNA_D[e] * (0.5f * (float)PI - el)) + PINNA_B[e];
+        shape.echoDelay[e] = fabsf(echo) * sampleScale;
+    }
+}
+
+// Renders one mono source to both ears. Direction changes glide across a block: delays
+// and gains interpolate per sample, shelf coefficients switch at the block start.
+class BinauralPanner {
+public:
+    void reset() {
+        memset(m_input, 0, sizeof(m_input));
+        memset(m_pinna, 0, sizeof(m_pinna));
+        m_writePos = 0;
+        m_shadowIn[0] = m_shadowIn[1] = 0.0f;
+        m_shadowOut[0] = m_shadowOut[1] = 0.0f;
+        m_primed = false;
+    }
+
+    void set_direction(float azimuthDeg, float elevationDeg) {
+        compute_binaural_shape(azimuthDeg, elevationDeg, m_target);
+        if (!m_primed) {
+            m_shape = m_target;
+            m_primed = true;
+        }
+    }
+
+    // Spatialize a mono block and add it to the mix
+    void render(const float* mono, float* left, float* right, int n) {
+        float step = 1.0f / (float)n;
+        float delayStep[2], gainStep[2], echoStep[PINNA_ECHOES];
+        for (int ear = 0; ear < 2; ear++) {
+            delayStep[ear] = (m_target.delay[ear] - m_shape.delay[ear]) * step;
+            gainStep[ear] = (m_target.gain[ear] - m_shape.gain[ear]) * step;
+        }
+        for (int e = 0; e < PINNA_ECHOES; e++) {
+            echoStep[e] = (m_target.echoDelay[e] - m_shape.echoDelay[e]) * step;
+        }
+        float* out[2] = { left, right };
+
+        for (int i = 0; i < n; i++) {
+            // Pinna: direct sound plus the echoes (shared by both ears)
+            m_input[m_writePos] = mono[i];
+            float pinna = mono[i];
+            for (int e = 0; e < PINNA_ECHOES; e++) {
+                m_shape.echoDelay[e] += echoStep[e];
+                pinna += PINNA_RHO[e] * binaural_tap(m_input, m_writePos, m_shape.echoDelay[e]);
+            }
+            m_pinna[m_writePos] = pinna;
+
+            // Per ear: arrival delay, head shadow, level
+            for (int ear = 0; ear < 2; ear++) {
+                m_shape.delay[ear] += delayStep[ear];
+                m_shape.gain[ear] += gainStep[ear];
+                float x = binaural_tap(m_pinna, m_writePos, m_shape.delay[ear]);
+                float y = m_target.b0[ear] * x + m_target.b1[ear] * m_shadowIn[ear] - m_target.a1[ear] * m_shadowOut[ear];
+                m_shadowIn[ear] = x;
+                m_shadowOut[ear] = y;
+                out[ear][i] += y * m_shape.gain[ear];
+            }
+            m_writePos = (m_writePos + 1) & (BINAURAL_DELAY_SIZE - 1);
+        }
+        m_shape = m_target;  // Exact end point (no accumulated rounding)
+    }
+
+private:
+    float m_input[BINAURAL_DELAY_SIZE] = {};   // Mono input history (pinna echoes)
+    float m_pinna[BINAURAL_DELAY_SIZE] = {};   // Pinna output history (ITD)
+    int m_writePos = 0;
+    float m_shadowIn[2] = {};                  // Head shadow filter state per ear
+    float m_shadowOut[2] = {};
+    BinauralShape m_shape = {};                // Settings reached at the end of the last block
+    BinauralShape m_target = {};
+    bool m_primed = false;                     // False = next direction applies without a glide
+};
+
+// ============================================================================
+// Voices (audio thread)
+// ============================================================================
+
+// Each voice keeps its own oscillator/envelope state and adds a block of up to
+// SYNTH_BLOCK frames into the left/right mix buffers.
+
+// Aim assist: primary tone (vertical precision) and click (horizontal precision)
+class AimVoice {
+public:
+    // Fresh start (aim_start, via AimParams::resetCount): chirp fully decayed, next pulse
+    // starts a new chirp
+    void reset_chirp() {
+        m_chirpDecay = 0.0f;
+        m_prevPulseOn = false;
+    }
+
+    // Once per device buffer: glide toward the published parameters, extrapolate motion
+    // and derive the block-rate values (pulse rate, thresholds)
+    void begin_buffer(const AimParams& params, int rampSamples, int frameCount, long long nowUs, bool binaural) {
+        if (params.resetCount != m_resetCount) {
+            reset_chirp();
+            m_resetCount = params.resetCount;
+        }
+        if (binaural && !m_binaural) m_panner.reset();
+        m_binaural = binaural;
+        m_active = params.active;
+        m_muted = params.muted;
+        m_horizEnabled = params.horizEnabled;
+
+        // Glide to the new targets over the ramp time; jump on start/unmute so a fresh
+        // target never sweeps in from the last one
+        int aimRamp = m_rampsPrimed ? rampSamples : 0;
+        m_rampsPrimed = m_active && !m_muted;
+
+        // New update: fold the extrapolated offset into the ramp start so the tone continues
+        // from where the prediction had taken it, then glides to the fresh measurement
+        if (params.sampleTimeUs != m_lastSampleTimeUs) {
+            if (m_panOffsetEnd != 0.0f) m_panRamp.rebase(m_panRamp.value + m_panOffsetEnd, aimRamp);
+            if (m_vertErrorOffset != 0.0f) m_vertErrorRamp.rebase(m_vertErrorRamp.value + m_vertErrorOffset, aimRamp);
+            m_panOffsetEnd = 0.0f;
+            m_vertErrorOffset = 0.0f;
+            m_lastSampleTimeUs = params.sampleTimeUs;
+        }
+        m_panRamp.retarget(params.pan, aimRamp);
+        m_pitchRamp.retarget(params.pitch, aimRamp);
+        m_vertErrorRamp.retarget(params.vertError, aimRamp);
+        m_horizErrorRamp.retarget(params.horizError, aimRamp);
+        m_vertThresholdRamp.retarget(params.vertThreshold, aimRamp);
+        m_horizThresholdRamp.retarget(params.horizThreshold, aimRamp);
+
+        // Extrapolation offsets at the start and end of this buffer (age clamped to the horizon)
+        float panOffsetStart = 0.0f;
+        float panOffsetEnd = 0.0f;
+        float vertErrorOffsetEnd = 0.0f;
+        if (params.panVelocity != 0.0f || params.vertErrorVelocity != 0.0f) {
+            static const float horizonSec = AIM_EXTRAPOLATE_MAX_MS / 1000.0f;
+            float ageStart = (float)(nowUs - params.sampleTimeUs) / 1000000.0f;
+            float ageEnd = ageStart + (float)frameCount / g_sampleRate;
+            ageStart = (ageStart < 0.0f) ? 0.0f : (ageStart > horizonSec) ? horizonSec : ageStart;
+            ageEnd = (ageEnd < 0.0f) ? 0.0f : (ageEnd > horizonSec) ? horizonSec : ageEnd;
+            panOffsetStart = params.panVelocity * ageStart;
+            panOffsetEnd = params.panVelocity * ageEnd;
+            vertErrorOffsetEnd = params.vertErrorVelocity * ageEnd;
+        }
+        m_panOffsetStep = (panOffsetEnd - panOffsetStart) / (float)frameCount;
+        m_panOffset = panOffsetStart;
+        m_panOffsetEnd = panOffsetEnd;
+        m_vertErrorOffset = vertErrorOffsetEnd;
+
+        m_pan = m_panRamp.value + m_panOffset;
+        m_pan = (m_pan < -1.0f) ? -1.0f : (m_pan > 1.0f) ? 1.0f : m_pan;
+        float vertError = m_vertErrorRamp.advance(frameCount) + vertErrorOffsetEnd;
+        vertError = (vertError < 0.0f) ? 0.0f : (vertError > 1.0f) ? 1.0f : vertError;
+        m_horizErrorRamp.advance(frameCount);
+        m_vertThreshold = m_vertThresholdRamp.advance(frameCount);    // Adaptive threshold from SQF
+        m_horizThreshold = m_horizThresholdRamp.advance(frameCount);  // Adaptive threshold from SQF
+
+        // Calculate primary tone pulse rate based on vertical error
+        // At dead center (vertError < threshold): continuous tone (pulseRate = 0)
+        // Near target: fast clicks, far from target: slow clicks
+        // Full dynamic range spread across useful aiming area [vertThreshold, VERT_ACTIVATE_THRESHOLD]
+        m_primaryPulseRate = 0.0f;
+        if (vertError >= m_vertThreshold) {
+            // Map vertError from [vertThreshold, VERT_ACTIVATE_THRESHOLD] to [MAX_PULSE_RATE, MIN_PULSE_RATE]
+            // Near target = fast clicks, far = slow clicks
+            float t = (vertError - m_vertThreshold) / (VERT_ACTIVATE_THRESHOLD - m_vertThreshold);
+            t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;  // Clamp to [0,1]
+            m_primaryPulseRate = MAX_PULSE_RATE + t * (MIN_PULSE_RATE - MAX_PULSE_RATE);
+        }
+        // When vertError < vertThreshold (on target), pulseRate stays 0 = continuous smooth tone
+        m_primaryPulseInc = phase_inc(m_primaryPulseRate);
+
+        // Pan-dependent gains, click rate and click frequency (updated per sample while pan ramps)
+        compute_aim_pan_shape(m_pan, m_horizThreshold, m_horizEnabled, m_shape);
+    }
+
+    void render(const SynthKernels& k, float* left, float* right, int n) {
+        // Low pass filter coefficient for click tone (one-pole filter)
+        const float clickLpfAlpha = 1.0f - expf(-2.0f * (float)PI * CLICK_LPF_CUTOFF / g_sampleRate);
+
+        const float chirpDecayPerSample = expf(-CHIRP_SWEEP_DECAY / g_sampleRate);
+
+        uint32_t phase[SYNTH_BLOCK];
+        uint32_t clickPhase[SYNTH_BLOCK];
+        float pan[SYNTH_BLOCK];
+        float envelope[SYNTH_BLOCK];
+        float octaveScale[SYNTH_BLOCK];
+        float clickEnvelope[SYNTH_BLOCK];
+        float clickLeft[SYNTH_BLOCK];
+        float clickRight[SYNTH_BLOCK];
+        bool audible = m_active && !m_muted;
+        bool anyClick = false;
+        m_primaryEnvelope.update_rate();
+        m_clickEnvelope.update_rate();
+
+        // Serial pass: ramps, chirp sweep, pulse gating and envelope slews
+        for (int i = 0; i < n; i++) {
+            // Smoothed (and extrapolated) aim pan and pitch
+            if (m_panRamp.remaining > 0 || m_panOffsetStep != 0.0f) {
+                m_panOffset += m_panOffsetStep;
+                m_pan = m_panRamp.next() + m_panOffset;
+                m_pan = (m_pan < -1.0f) ? -1.0f : (m_pan > 1.0f) ? 1.0f : m_pan;
+                compute_aim_pan_shape(m_pan, m_horizThreshold, m_horizEnabled, m_shape);
+            }
+            float freq = m_pitchRamp.next();
+
+            if (audible) {
+                // Detect rising edge of pulse (start of new click) to reset chirp
+                bool currentPulseOn = (m_primaryPulseRate > 0.0f) ? osc_first_half(m_pulsePhase) : true;
+                if (currentPulseOn && !m_prevPulseOn) {
+                    m_chirpDecay = 1.0f;  // Reset chirp at start of each new click
+                }
+                m_prevPulseOn = currentPulseOn;
+
+                // Determine sweep direction from pitch vs center
+                // Dead zone matches adaptive on-target threshold (no more gap at long range)
+                // Aim below target (pitch < 550) → descending pew: freq+range → freq → "move up"
+                // Aim above target (pitch > 550) → ascending whoop: freq → freq+range → "move down"
+                float deadZoneHz = m_vertThreshold * 250.0f;  // Convert vertThreshold to Hz
+                bool moveDown = freq > CHIRP_CENTER_FREQ + deadZoneHz;
+                float instantFreq;
+                if (freq < CHIRP_CENTER_FREQ - deadZoneHz) {
+                    // "Move up" — descending pew: starts at freq+range, decays to freq
+                    instantFreq = freq + CHIRP_SWEEP_RANGE * m_chirpDecay;
+                } else if (moveDown) {
+                    // "Move down" — ascending whoop: starts at freq, rises to freq+range
+                    instantFreq = freq + CHIRP_SWEEP_RANGE * (1.0f - m_chirpDecay);
+                } else {
+                    // Within on-target zone — no sweep, steady tone
+                    instantFreq = freq;
+                }
+                m_chirpDecay *= chirpDecayPerSample;
+
+                // Triangle phase with swept frequency; "move down" adds an octave harmonic
+                // for a distinct, richer timbre
+                phase[i] = m_phase;
+                m_phase += phase_inc(instantFreq);
+                octaveScale[i] = moveDown ? BASE_VOLUME * CHIRP_DOWN_OCTAVE_MIX : 0.0f;
+
+                // Pulse envelope with smooth attack/release ramps (default: continuous tone)
+                float targetPrimaryEnvelope = 1.0f;
+                if (m_primaryPulseRate > 0.0f) {
+                    targetPrimaryEnvelope = currentPulseOn ? 1.0f : 0.0f;
+                }
+                envelope[i] = m_primaryEnvelope.follow(targetPrimaryEnvelope);
+                pan[i] = m_pan;
+
+                // Secondary click: mono in the ear toward the target, both ears when on target
+                clickPhase[i] = m_clickPhase;
+                clickLeft[i] = 0.0f;
+                clickRight[i] = 0.0f;
+                clickEnvelope[i] = -1.0f;  // Inactive: filter holds, nothing mixed
+                if (m_shape.secondaryActive) {
+                    anyClick = true;
+                    float targetEnvelope = 1.0f;  // Default: full on (continuous tone)
+                    if (m_shape.secondaryPulseRate > 0.0f) {
+                        // Pulsing mode: target is 1 when sin > 0, else 0
+                        targetEnvelope = osc_first_half(m_clickPulsePhase) ? 1.0f : 0.0f;
+                    }
+                    clickEnvelope[i] = m_clickEnvelope.follow(targetEnvelope);
+
+                    if (m_shape.panMagnitude < m_horizThreshold) {
+                        clickLeft[i] = 1.0f;   // On target - centered
+                        clickRight[i] = 1.0f;
+                    } else if (m_pan < 0.0f) {
+                        clickLeft[i] = 1.0f;   // Target is to the left
+                    } else {
+                        clickRight[i] = 1.0f;  // Target is to the right
+                    }
+                }
+            }
+
+            // Pulse and click phases run even while muted
+            if (m_primaryPulseRate > 0.0f) {
+                m_pulsePhase += m_primaryPulseInc;
+            } else {
+                m_pulsePhase = 0;  // Reset when continuous
+            }
+            m_clickPhase += m_shape.clickPhaseInc;
+            if (m_shape.secondaryPulseRate > 0.0f) {
+                m_clickPulsePhase += m_shape.clickPulseInc;
+            } else {
+                m_clickPulsePhase = 0;  // Reset when continuous
+            }
+        }
+
+        if (!audible) return;
+
+        // Primary tone: panned triangle (+ octave) under the pulse envelope
+        float tone[SYNTH_BLOCK];
+        float leftGain[SYNTH_BLOCK];
+        float rightGain[SYNTH_BLOCK];
+        k.triangle_octave(phase, BASE_VOLUME, octaveScale, tone, n);
+        k.mul(tone, envelope, n);
+        if (m_binaural) {
+            m_panner.set_direction(m_pan * BINAURAL_PAN_AZIMUTH, 0.0f);
+            m_panner.render(tone, left, right, n);
+        } else {
+            pan_law_block(k, pan, leftGain, rightGain, n);
+            k.mix(tone, leftGain, rightGain, left, right, n);
+        }
+
+        // Click: triangle through the one-pole low pass (4100 Hz), then its envelope.
+        // Always on the ear toward the target (a left/right cue, not a position).
+        if (anyClick) {
+            float click[SYNTH_BLOCK];
+            k.triangle(clickPhase, CLICK_VOLUME, click, n);
+            for (int i = 0; i < n; i++) {
+                if (clickEnvelope[i] < 0.0f) {
+                    click[i] = 0.0f;
+                    continue;
+                }
+                m_clickLpf += clickLpfAlpha * (click[i] - m_clickLpf);
+                click[i] = m_clickLpf * clickEnvelope[i];
+            }
+            k.mix(click, clickLeft, clickRight, left, right, n);
+        }
+    }
+
+private:
+    // Block-rate parameters (begin_buffer)
+    bool m_active = false;
+    bool m_muted = false;
+    bool m_horizEnabled = false;
+    float m_vertThreshold = 0.02f;
+    float m_horizThreshold = 0.005f;
+    float m_primaryPulseRate = 0.0f;
+    uint32_t m_primaryPulseInc = 0;
+
+    // Smoothing: pan and pitch ramp per sample, errors and thresholds per buffer
+    ParamRamp m_panRamp;
+    ParamRamp m_pitchRamp;
+    ParamRamp m_vertErrorRamp;
+    ParamRamp m_horizErrorRamp;
+    ParamRamp m_vertThresholdRamp;
+    ParamRamp m_horizThresholdRamp;
+    bool m_rampsPrimed = false;        // False = next audible update jumps (start/unmute)
+    uint32_t m_resetCount = 0;         // AimParams::resetCount last applied
+
+    // Extrapolation: between updates, pan and vertError continue along the velocities sent
+    // with the last update, for at most AIM_EXTRAPOLATE_MAX_MS
+    long long m_lastSampleTimeUs = 0;  // Update currently being extrapolated
+    float m_panOffset = 0.0f;          // Current extrapolated pan offset
+    float m_panOffsetStep = 0.0f;      // Per-sample change of the pan offset this buffer
+    float m_panOffsetEnd = 0.0f;       // Offset reached at the end of the last buffer
+    float m_vertErrorOffset = 0.0f;
+
+    // Pan and everything derived from it
+    float m_pan = 0.0f;
+    AimPanShape m_shape = {};
+
+    // Oscillators, envelopes and filter
+    uint32_t m_phase = 0;              // Primary tone phase
+    uint32_t m_pulsePhase = 0;         // Primary tone pulse envelope phase
+    uint32_t m_clickPhase = 0;         // Secondary click tone phase
+    uint32_t m_clickPulsePhase = 0;    // Secondary click pulse envelope phase
+    float m_clickLpf = 0.0f;           // Low pass filter state for click tone
+    Envelope m_clickEnvelope{ CLICK_ATTACK_MS, 0.0f, CLICK_RELEASE_MS };        // Click pulse gate
+    Envelope m_primaryEnvelope{ PRIMARY_ATTACK_MS, 0.0f, PRIMARY_RELEASE_MS };  // Primary tone pulse gate
+    bool m_prevPulseOn = false;        // Pulse on/off last sample (chirp reset)
+    float m_chirpDecay = 0.0f;         // exp(-CHIRP_SWEEP_DECAY * time since chirp start)
+
+    // Binaural rendering of the primary tone (spatial:aim,binaural)
+    bool m_binaural = false;
+    BinauralPanner m_panner;
+};
+
+// One-shot sine blip (vertical lock / unlock) with attack/sustain/release
+class BlipVoice {
+public:
+    explicit BlipVoice(float freq) : m_freq(freq) {}
+
+    bool playing() const { return m_envelope.active(); }
+
+    void start() {
+        m_phaseInc = phase_inc(m_freq);
+        m_envelope.trigger();
+        m_phase = 0;
+    }
+
+    // Render until the blip ends or n frames; returns the frames rendered
+    int render(const SynthKernels& k, float* left, float* right, int n) {
+        float envelope[SYNTH_BLOCK];
+        int count = m_envelope.render(envelope, n);
+
+        uint32_t phase[SYNTH_BLOCK];
+        float tone[SYNTH_BLOCK];
+        m_phase = k.phase_ramp(m_phase, m_phaseInc, phase, count);
+        k.sine(phase, BLIP_VOLUME, tone, count);
+        k.mul(tone, envelope, count);
+        k.mix_const(tone, 1.0f, 1.0f, left, right, count);  // Mono
+        return count;
+    }
+
+private:
+    float m_freq;
+    uint32_t m_phaseInc = 0;
+    uint32_t m_phase = 0;
+    Envelope m_envelope{ BLIP_ATTACK_MS, BLIP_SUSTAIN_MS, BLIP_RELEASE_MS };
+};
+
+// Terrain radar beep: one queued beep at a time, waveform and pitch by material
+class RadarVoice {
+public:
+    bool playing() const { return m_envelope.active(); }
+
+    // Loudness for quietest-first stealing (envelope x distance volume); a beep still in
+    // its attack counts at full level so a just-started beep is not stolen straight away
+    float level() const { return m_envelope.attacking() ? m_volume : m_envelope.level() * m_volume; }
+
+    void stop() {
+        m_envelope.reset();
+    }
+
+    void start(const RadarBeep& beep, bool binaural) {
+        m_pan = beep.pan;
+        m_volume = beep.volume;
+        m_material = beep.material;
+
+        // Stereo gains under the current pan law (fixed for the beep)
+        if (g_panLaw.load(std::memory_order_relaxed) == PAN_LAW_LINEAR) {
+            m_leftGain = (m_pan <= 0.0f) ? 1.0f : (1.0f - m_pan);
+            m_rightGain = (m_pan >= 0.0f) ? 1.0f : (1.0f + m_pan);
+        } else {
+            pan_law_gains(m_pan, m_leftGain, m_rightGain);
+        }
+
+        // Each beep is a new source: clear the panner and place it without a glide
+        m_binaural = binaural;
+        if (binaural) {
+            m_panner.reset();
+            m_panner.set_direction(beep.azimuth, beep.elevation);
+        }
+
+        // Select frequency based on material
+        float freq;
+        switch (m_material) {
+            case 1: freq = RADAR_FREQ_GRASS; break;
+            case 2: freq = RADAR_FREQ_CONCRETE; break;
+            case 3: freq = RADAR_FREQ_WOOD; break;
+            case 4: freq = RADAR_FREQ_METAL; break;
+            case 5: freq = RADAR_FREQ_WATER; break;
+            case 6: freq = RADAR_FREQ_MAN; break;
+            case 7: freq = RADAR_FREQ_GLASS; break;
+            default: freq = RADAR_FREQ_DEFAULT; break;
+        }
+        m_phaseInc = phase_inc(freq);
+        m_phaseInc2 = phase_inc(freq * 2.3f);
+
+        m_envelope.trigger();
+        m_phase = 0;
+        m_phase2 = 0;
+    }
+
+    // Render until the beep ends or n frames; returns the frames rendered
+    int render(const SynthKernels& k, float* left, float* right, int n) {
+        float gain[SYNTH_BLOCK];
+        int count = m_envelope.render(gain, n);
+        for (int i = 0; i < count; i++) {
+            gain[i] = gain[i] * m_volume * RADAR_BASE_VOLUME;
+        }
+
+        float tone[SYNTH_BLOCK];
+        render_tone(k, tone, count);
+
+        // Apply volume and envelope, then stereo panning
+        k.mul(tone, gain, count);
+        if (m_binaural) {
+            m_panner.render(tone, left, right, count);
+            return count;
+        }
+        k.mix_const(tone, m_leftGain, m_rightGain, left, right, count);
+        return count;
+    }
+
+    // Material waveform at full scale (no envelope, volume or pan) for up to SYNTH_BLOCK
+    // frames; advances the oscillators
+    void render_tone(const SynthKernels& k, float* tone, int count) {
+        uint32_t phase[SYNTH_BLOCK];
+        uint32_t phase2[SYNTH_BLOCK];
+        float partial[SYNTH_BLOCK];
+        uint32_t startPhase = m_phase;
+        m_phase = k.phase_ramp(m_phase, m_phaseInc, phase, count);
+
+        // Generate waveform based on material
+        switch (m_material) {
+            case 1:  // grass - sine (soft)
+                k.sine(phase, 1.0f, tone, count);
+                break;
+            case 2:  // concrete - square (harsh), band-limited
+                k.pulse_blep(phase, m_phaseInc, 0x80000000u, 1.0f, -1.0f, tone, count);
+                break;
+            case 3:  // wood - triangle (organic)
+                k.triangle(phase, 1.0f, tone, count);
+                break;
+            case 4:  // metal - sawtooth (buzzy), band-limited
+                k.saw_blep(phase, m_phaseInc, tone, count);
+                break;
+            case 5:  // water - filtered noise approximation (low sine with inharmonic partial)
+                m_phase2 = k.phase_ramp(m_phase2, m_phaseInc2, phase2, count);
+                k.sine(phase, 0.7f, tone, count);
+                k.sine(phase2, 0.3f, partial, count);
+                k.add(partial, tone, count);
+                break;
+            case 6:  // man - pulse (25% duty cycle, distinct alert), band-limited
+                k.pulse_blep(phase, m_phaseInc, 0x40000000u, 1.0f, -0.3f, tone, count);
+                break;
+            case 7:  // glass - sine + harmonic (bright)
+                k.phase_ramp(startPhase << 1, m_phaseInc << 1, phase2, count);
+                k.sine(phase, 0.8f, tone, count);
+                k.sine(phase2, 0.2f, partial, count);
+                k.add(partial, tone, count);
+                break;
+            default:  // default - sine
+                k.sine(phase, 1.0f, tone, count);
+                break;
+        }
+    }
+
+private:
+    // Beep being played (consumed from the queue at beep start)
+    float m_pan = 0.0f;
+    float m_leftGain = 1.0f;
+    float m_rightGain = 1.0f;
+    float m_volume = 0.5f;
+    int m_material = 0;
+    uint32_t m_phaseInc = 0;
+    uint32_t m_phaseInc2 = 0;
+
+    uint32_t m_phase = 0;          // Beep oscillator phase
+    uint32_t m_phase2 = 0;         // Inharmonic partial (water)
+    Envelope m_envelope{ RADAR_ATTACK_MS, RADAR_SUSTAIN_MS, RADAR_RELEASE_MS };
+    bool m_binaural = false;       // Spatial mode when the beep started
+    BinauralPanner m_panner;
+};
+
+// Navigation beacon: triangle with frequency sweep, pulsing and LPF
+class BeaconVoice {
+public:
+    // Applied from begin_buffer when BeaconParams::resetCount changes (beacon_start/stop)
+    void reset() {
+        m_phase = 0;
+        m_pulsePhase = 0;
+        m_lpf = 0.0f;
+        m_envelope.reset();
+        m_panner.reset();
+    }
+
+    // Once per device buffer: glide toward the published pan (jump when just started)
+    void begin_buffer(const BeaconParams& params, int rampSamples, bool binaural) {
+        if (params.resetCount != m_resetCount) {
+            reset();
+            m_resetCount = params.resetCount;
+        }
+        int ramp = m_rampPrimed ? rampSamples : 0;
+        m_panRamp.retarget(params.pan, ramp);
+        m_rampPrimed = params.active;
+        if (binaural && !m_binaural) m_panner.reset();
+        m_binaural = binaural;
+
+        // Azimuth glides the short way round (350 -> 10 passes through 0, not 180),
+        // kept within one turn of zero
+        m_hasDirection = params.hasDirection;
+        float azimuth = params.azimuth;
+        while (azimuth - m_azimuthRamp.target > 180.0f) azimuth -= 360.0f;
+        while (azimuth - m_azimuthRamp.target < -180.0f) azimuth += 360.0f;
+        m_azimuthRamp.retarget(azimuth, ramp);
+        m_elevationRamp.retarget(params.elevation, ramp);
+        if (fabsf(m_azimuthRamp.target) > 360.0f) {
+            float turn = (m_azimuthRamp.target > 0.0f) ? 360.0f : -360.0f;
+            m_azimuthRamp.value -= turn;
+            m_azimuthRamp.target -= turn;
+        }
+    }
+
+    void render(const SynthKernels& k, float* left, float* right, int n) {
+        if (n <= 0) return;
+        const float lpfAlpha = 1.0f - expf(-2.0f * (float)PI * BEACON_LPF_CUTOFF / g_sampleRate);
+        m_envelope.update_rate();
+
+        uint32_t phase[SYNTH_BLOCK];
+        float envelope[SYNTH_BLOCK];
+        float widePan[SYNTH_BLOCK];
+        for (int i = 0; i < n; i++) {
+            float pan = m_panRamp.next();
+
+            // Calculate pan magnitude and centeredness (0 = far, 1 = centered)
+            float panMagnitude = fabsf(pan);
+            float centeredness = 1.0f - (panMagnitude / 0.2f);  // 0.2 = max useful range
+            centeredness = (centeredness < 0.0f) ? 0.0f : (centeredness > 1.0f) ? 1.0f : centeredness;
+
+            // Frequency sweep: 400 Hz (off center) to 460 Hz (centered)
+            float freq = BEACON_FREQ_MIN + centeredness * (BEACON_FREQ_MAX - BEACON_FREQ_MIN);
+            m_phase += phase_inc(freq);
+            phase[i] = m_phase;
+
+            // Calculate pulse rate based on pan magnitude
+            float pulseRate = 0.0f;  // 0 = continuous
+            if (panMagnitude >= BEACON_CENTER_THRESHOLD) {
+                // Map pan [0.05, 0.2+] to pulse rate [15 Hz, 2 Hz]
+                float t = (panMagnitude - BEACON_CENTER_THRESHOLD) / (0.2f - BEACON_CENTER_THRESHOLD);
+                t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;
+                pulseRate = BEACON_MAX_PULSE_RATE + t * (BEACON_MIN_PULSE_RATE - BEACON_MAX_PULSE_RATE);
+            }
+
+            // Calculate pulse envelope (square wave envelope for on/off)
+            float targetEnvelope = 1.0f;
+            if (pulseRate > 0.0f) {
+                m_pulsePhase += phase_inc(pulseRate);
+                targetEnvelope = osc_first_half(m_pulsePhase) ? 1.0f : 0.0f;
+            } else {
+                m_pulsePhase = 0;  // Reset when continuous
+            }
 
             // Smooth attack/release envelope (5ms each for hearing safety)
-            static const float beaconSamplesPerMs = SAMPLE_RATE / 1000.0f;
-            static const float beaconAttackCoef = 1.0f / (BEACON_ATTACK_MS * beaconSamplesPerMs);
-            static const float beaconReleaseCoef = 1.0f / (BEACON_RELEASE_MS * beaconSamplesPerMs);
-
-            if (g_beaconEnvelopeState < targetEnvelope) {
-                g_beaconEnvelopeState += beaconAttackCoef;
-                if (g_beaconEnvelopeState > targetEnvelope) g_beaconEnvelopeState = targetEnvelope;
-            } else if (g_beaconEnvelopeState > targetEnvelope) {
-                g_beaconEnvelopeState -= beaconReleaseCoef;
-                if (g_beaconEnvelopeState < targetEnvelope) g_beaconEnvelopeState = targetEnvelope;
+            envelope[i] = m_envelope.follow(targetEnvelope);
+
+            // Stereo panning - widen by 2x for more dramatic separation
+            float wide = pan * 2.0f;
+            widePan[i] = (wide > 1.0f) ? 1.0f : (wide < -1.0f) ? -1.0f : wide;
+        }
+
+        // Triangle through the one-pole low pass (4000 Hz), then volume and envelope
+        float tone[SYNTH_BLOCK];
+        k.triangle(phase, 1.0f, tone, n);
+        for (int i = 0; i < n; i++) {
+            m_lpf += lpfAlpha * (tone[i] - m_lpf);
+            tone[i] = m_lpf * BEACON_VOLUME * envelope[i];
+        }
+
+        // Binaural: the sent direction (front/back, elevation) or else pan as +-90 degrees
+        if (m_binaural) {
+            float azimuth = m_azimuthRamp.advance(n);
+            float elevation = m_elevationRamp.advance(n);
+            if (m_hasDirection) {
+                m_panner.set_direction(azimuth, elevation);
+            } else {
+                m_panner.set_direction(m_panRamp.value * BINAURAL_PAN_AZIMUTH, 0.0f);
             }
+            m_panner.render(tone, left, right, n);
+            return;
+        }
+
+        float leftGain[SYNTH_BLOCK];
+        float rightGain[SYNTH_BLOCK];
+        pan_law_block(k, widePan, leftGain, rightGain, n);
+        k.mix(tone, leftGain, rightGain, left, right, n);
+    }
+
+private:
+    ParamRamp m_panRamp;           // Pan ramps per sample
+    ParamRamp m_azimuthRamp;       // Direction (binaural) ramps per block
+    ParamRamp m_elevationRamp;
+    bool m_hasDirection = false;
+    bool m_binaural = false;
+    BinauralPanner m_panner;
+    bool m_rampPrimed = false;
+    uint32_t m_resetCount = 0;     // BeaconParams::resetCount last applied
+    uint32_t m_phase = 0;          // Oscillator phase
+    uint32_t m_pulsePhase = 0;     // Pulse envelope phase
+    float m_lpf = 0.0f;            // Low pass filter state
+    Envelope m_envelope{ BEACON_ATTACK_MS, 0.0f, BEACON_RELEASE_MS };  // Pulse gate
+};
+
+static AimVoice g_aimVoice;
+static BlipVoice g_blipVoice(BLIP_FREQ);
+static BlipVoice g_unlockBlipVoice(UNLOCK_BLIP_FREQ);
+static BeaconVoice g_beaconVoice;
+
+class RadarVoicePool {
+public:
+    void stop_all() {
+        for (RadarVoice& voice : m_voices) voice.stop();
+    }
+
+    // Start a beep on a free voice, stealing one if all are busy
+    void start(const RadarBeep& beep, int stealPolicy, bool binaural) {
+        int slot = -1;
+        for (int i = 0; i < RADAR_VOICE_COUNT; i++) {
+            if (!m_voices[i].playing()) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0) {
+            slot = 0;
+            for (int i = 1; i < RADAR_VOICE_COUNT; i++) {
+                bool better = (stealPolicy == RADAR_STEAL_QUIETEST)
+                    ? m_voices[i].level() < m_voices[slot].level()
+                    : (int)(m_startOrder[i] - m_startOrder[slot]) < 0;
+                if (better) slot = i;
+            }
+            g_radarVoicesStolen.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_voices[slot].start(beep, binaural);
+        m_startOrder[slot] = m_nextStart++;
+        g_radarBeepsStarted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Mix every playing voice into the block; returns how many are still playing
+    int render(const SynthKernels& k, float* left, float* right, int n) {
+        int active = 0;
+        for (RadarVoice& voice : m_voices) {
+            if (!voice.playing()) continue;
+            voice.render(k, left, right, n);
+            if (voice.playing()) active++;
+        }
+        return active;
+    }
+
+private:
+    RadarVoice m_voices[RADAR_VOICE_COUNT];
+    unsigned int m_startOrder[RADAR_VOICE_COUNT] = {};  // Start sequence (oldest-first stealing)
+    unsigned int m_nextStart = 0;
+};
+static RadarVoicePool g_radarPool;
+
+// Sweep position on the audio clock. Sample index i of a sweep is due at frame
+// i * period / count; after the last index the clock wraps into the next sweep.
+class RadarSweepClock {
+public:
+    void restart(int periodFrames, int sampleCount) {
+        m_periodFrames = periodFrames;
+        m_sampleCount = sampleCount;
+        m_position = 0;
+        m_nextIndex = 0;
+        m_sweep = 0;
+    }
+
+    // Frames from the current position until the next index is due
+    long long frames_until_next() const {
+        return (long long)m_nextIndex * m_periodFrames / m_sampleCount - m_position;
+    }
+
+    // Index that is due now; moves on to the next one
+    int take() {
+        int index = m_nextIndex++;
+        if (m_nextIndex >= m_sampleCount) {
+            m_nextIndex = 0;
+            m_sweep++;
+            m_position -= m_periodFrames;
+        }
+        return index;
+    }
+
+    void advance(int frames) { m_position += frames; }
+
+    unsigned int sweep() const { return m_sweep; }
+
+    // Next index due, counted across sweeps (the sample number SQF uploads hits for)
+    long long sample() const { return (long long)m_sweep * m_sampleCount + m_nextIndex; }
+
+private:
+    int m_periodFrames = 0;
+    int m_sampleCount = 1;
+    long long m_position = 0;        // Frames since the start of the current sweep
+    int m_nextIndex = 0;
+    unsigned int m_sweep = 0;        // Sweeps completed since the restart
+};
+static RadarSweepClock g_radarSweepClock;
+static unsigned int g_radarSweepClockGeneration = 0;  // Generation the clock was restarted for
+
+// Start the beep uploaded for a sweep index (skipped if silent, mid-update, or uploaded
+// for a sweep before the last one: SQF stopped casting, so the hit no longer matches the view)
+static void start_radar_sweep_beep(int index, unsigned int sweep, int stealPolicy, bool binaural) {
+    RadarSweepHit hit;
+    if (g_radarSweepHits[index].try_read(hit) && hit.audible && (int)(sweep - hit.sweep) <= 1) {
+        g_radarPool.start(hit.beep, stealPolicy, binaural);
+    }
+}
+
+// Retrigger a blip as soon as the previous one ends (per sample, as before blocks); a
+// trigger set while a frame is open waits for the frame to finish
+static void render_blip(BlipVoice& voice, std::atomic<bool>& pending, const SynthKernels& k, float* left, float* right, int n) {
+    int done = 0;
+    while (done < n) {
+        if (!voice.playing()) {
+            unsigned int seq;
+            if (!frame_gate_open(seq) || !pending.load() || !frame_gate_still_open(seq)) return;
+            pending.store(false);
+            voice.start();
+        }
+        done += voice.render(k, left + done, right + done, n - done);
+    }
+}
+
+// Apply a radar_start/radar_stop reset (once per buffer): drain the ring and the pan
+// buckets, silence the pool. A bucket mid-publish holds a newer beep and is kept.
+static unsigned int g_radarResetApplied = 0;  // Generation last applied (audio callback only)
+static void apply_radar_reset() {
+    unsigned int seq;
+    if (!frame_gate_open(seq)) return;
+    unsigned int generation = g_radarResetGeneration.load(std::memory_order_acquire);
+    if (generation == g_radarResetApplied || !frame_gate_still_open(seq)) return;
+    g_radarResetApplied = generation;
+
+    g_radarQueueTail.store(g_radarQueueHead.load(std::memory_order_acquire), std::memory_order_release);
+    for (int b = 0; b < RADAR_PAN_BUCKETS; b++) {
+        RadarBucketBeep slot;
+        if (g_radarBuckets[b].try_read(slot)) {
+            g_radarBucketPlayedSeq[b].store(slot.seq, std::memory_order_release);
+        }
+    }
+    g_radarPool.stop_all();
+    g_radarVoicesActive.store(0, std::memory_order_relaxed);
+}
+
+// Start every beep queued since the last block (ring, then coalesced pan buckets). Beeps
+// queued by a frame still in progress wait for a later block.
+static void start_queued_radar_beeps(int stealPolicy, bool binaural) {
+    unsigned int seq;
+    if (!frame_gate_open(seq)) return;
+    int tail = g_radarQueueTail.load(std::memory_order_acquire);
+    int head = g_radarQueueHead.load(std::memory_order_acquire);
+    if (!frame_gate_still_open(seq)) return;
+    while (tail != head) {
+        RadarBeep beep = g_radarQueue[tail];
+        // A failed CAS means the producer dropped this beep (tail now holds the new value)
+        if (g_radarQueueTail.compare_exchange_strong(tail, (tail + 1) % RADAR_QUEUE_SIZE, std::memory_order_acq_rel)) {
+            if (beep.queuedNs != 0) record_control_latency(LATENCY_RADAR_BEEP, beep.queuedNs);
+            g_radarPool.start(beep, stealPolicy, binaural);
+            tail = (tail + 1) % RADAR_QUEUE_SIZE;
+        }
+    }
+
+    for (int b = 0; b < RADAR_PAN_BUCKETS; b++) {
+        RadarBucketBeep slot;
+        if (!g_radarBuckets[b].try_read(slot)) continue;
+        if (!frame_gate_still_open(seq)) return;
+        if (slot.seq != g_radarBucketPlayedSeq[b].load(std::memory_order_relaxed)) {
+            g_radarBucketPlayedSeq[b].store(slot.seq, std::memory_order_release);
+            if (slot.beep.queuedNs != 0) record_control_latency(LATENCY_RADAR_BEEP, slot.beep.queuedNs);
+            g_radarPool.start(slot.beep, stealPolicy, binaural);
+        }
+    }
+}
+
+// Start queued beeps, then mix the pool. Sweep beeps start on their exact frame: the
+// block is rendered in pieces split at each due index. They are not held for an open
+// frame: a frame uploads hits ahead of the clock, and the one due now is either its old
+// or its new hit, both whole.
+static void render_radar(const SynthKernels& k, bool binaural, float* left, float* right, int n) {
+    int stealPolicy = g_radarStealPolicy.load(std::memory_order_relaxed);
+    start_queued_radar_beeps(stealPolicy, binaural);
+
+    int done = 0;
+    if (g_radarSweepActive.load(std::memory_order_relaxed)) {
+        unsigned int generation = g_radarSweepGeneration.load(std::memory_order_acquire);
+        if (generation != g_radarSweepClockGeneration) {
+            g_radarSweepClock.restart(g_radarSweepPeriodFrames.load(std::memory_order_relaxed),
+                                      g_radarSweepSampleCount.load(std::memory_order_relaxed));
+            g_radarSweepClockGeneration = generation;
+            g_radarSweepPosition.store(0, std::memory_order_relaxed);
+        }
+        for (;;) {
+            long long wait = g_radarSweepClock.frames_until_next();
+            if (wait >= n - done) break;
+            if (wait > 0) {
+                g_radarPool.render(k, left + done, right + done, (int)wait);
+                g_radarSweepClock.advance((int)wait);
+                done += (int)wait;
+            }
+            unsigned int sweep = g_radarSweepClock.sweep();
+            start_radar_sweep_beep(g_radarSweepClock.take(), sweep, stealPolicy, binaural);
+            g_radarSweepPosition.store(g_radarSweepClock.sample(), std::memory_order_relaxed);
+        }
+        g_radarSweepClock.advance(n - done);
+    }
+
+    int active = g_radarPool.render(k, left + done, right + done, n - done);
+    g_radarVoicesActive.store(active, std::memory_order_relaxed);
+    if (active > g_radarVoicesPeak.load(std::memory_order_relaxed)) {
+        g_radarVoicesPeak.store(active, std::memory_order_relaxed);
+    }
+}
+
+// ============================================================================
+// Mixer (audio thread)
+// ============================================================================
+
+// Look-ahead peak limiter on the master bus. The output is delayed by the look-ahead;
+// the gain each sample needs (ceiling / peak) is held at its minimum over the look-ahead
+// window and then averaged over the same window, so the gain is already down when a peak
+// leaves the delay line and no sample exceeds the ceiling. Recovery is a one-pole release.
+class PeakLimiter {
+public:
+    void reset() {
+        m_lookahead = std::min(LIMITER_RING - 1, std::max(1, ms_to_samples(LIMITER_LOOKAHEAD_MS)));
+        memset(m_delayLeft, 0, sizeof(m_delayLeft));
+        memset(m_delayRight, 0, sizeof(m_delayRight));
+        for (float& h : m_held) h = 1.0f;
+        m_heldSum = (double)m_lookahead;
+        m_minHead = m_minTail = 0;
+        m_pos = 0;
+        m_time = 0;
+        m_envelope = 1.0f;
+    }
+
+    // Limit a stereo block in place; returns the lowest gain applied
+    float process(float ceiling, float* left, float* right, int n) {
+        const float releaseCoef = 1.0f - expf(-1.0f / (LIMITER_RELEASE_MS * g_sampleRate / 1000.0f));
+        const int mask = LIMITER_RING - 1;
+        float lowest = 1.0f;
+        for (int i = 0; i < n; i++) {
+            float peak = std::max(fabsf(left[i]), fabsf(right[i]));
+            float need = (peak > ceiling) ? ceiling / peak : 1.0f;
+
+            // Sliding-window minimum of the needed gain (monotonic queue)
+            while (m_minTail != m_minHead && m_minGain[(m_minTail - 1) & mask] >= need) m_minTail--;
+            m_minGain[m_minTail & mask] = need;
+            m_minTime[m_minTail & mask] = m_time;
+            m_minTail++;
+            if (m_time - m_minTime[m_minHead & mask] >= (unsigned int)m_lookahead) m_minHead++;
+            float held = m_minGain[m_minHead & mask];
+
+            // Average the held gain over the window
+            int slot = (int)(m_time % (unsigned int)m_lookahead);
+            m_heldSum += (double)held - (double)m_held[slot];
+            m_held[slot] = held;
+            float target = std::min(1.0f, (float)(m_heldSum / m_lookahead));
+
+            // Down immediately, back up at the release rate
+            m_envelope = (target < m_envelope) ? target : m_envelope + (target - m_envelope) * releaseCoef;
+            lowest = std::min(lowest, m_envelope);
+
+            // Delay line: write the new sample, play the one from the start of the window
+            m_delayLeft[m_pos] = left[i];
+            m_delayRight[m_pos] = right[i];
+            int out = (m_pos - (m_lookahead - 1)) & mask;
+            left[i] = m_delayLeft[out] * m_envelope;
+            right[i] = m_delayRight[out] * m_envelope;
+            m_pos = (m_pos + 1) & mask;
+            m_time++;
+        }
+        return lowest;
+    }
+
+private:
+    static const int LIMITER_RING = 256;  // Power of 2, > look-ahead samples at 96 kHz
+    int m_lookahead = 1;                  // Samples at the device rate (reset)
+    float m_delayLeft[LIMITER_RING] = {};
+    float m_delayRight[LIMITER_RING] = {};
+    float m_held[LIMITER_RING] = {};
+    double m_heldSum = 0.0;
+    float m_minGain[LIMITER_RING] = {};
+    unsigned int m_minTime[LIMITER_RING] = {};
+    unsigned int m_minHead = 0;          // Queue positions (wrap freely, masked on access)
+    unsigned int m_minTail = 0;
+    int m_pos = 0;
+    unsigned int m_time = 0;
+    float m_envelope = 1.0f;
+};
+
+// Bus and master gains (glided like the voice parameters) plus the limiter
+class Mixer {
+public:
+    Mixer() { m_limiter.reset(); }
+
+    // Device reopened at a new rate (the look-ahead is in samples)
+    void reset_limiter() { m_limiter.reset(); }
+
+    // Once per device buffer
+    void begin_buffer(const MixerParams& params, int rampSamples, long long nowUs) {
+        for (int bus = 0; bus < MIX_BUS_COUNT; bus++) {
+            m_busGain[bus].retarget(params.busGain[bus], rampSamples);
+        }
+        m_masterGain.retarget(params.masterGain, rampSamples);
+        if (params.limiterEnabled && !m_limiterEnabled) m_limiter.reset();
+        m_limiterEnabled = params.limiterEnabled;
+        m_ceiling = params.limiterCeiling;
+
+        // Ducking: speaking (plus the hold time) pulls the ducked buses down
+        long long busyUntil = g_speechBusyUntilUs.load(std::memory_order_relaxed);
+        bool speaking = nowUs < busyUntil + (long long)(params.duckHoldMs * 1000.0f);
+        m_duckTarget = (params.duckEnabled && speaking) ? params.duckGain : 1.0f;
+        float depth = std::max(1.0f - params.duckGain, fabsf(m_duck - m_duckTarget));  // Depth may have changed
+        m_duckAttackStep = depth / std::max(1.0f, params.duckAttackMs * g_sampleRate / 1000.0f);
+        m_duckReleaseStep = depth / std::max(1.0f, params.duckReleaseMs * g_sampleRate / 1000.0f);
+    }
+
+    // Once per block, before the buses: move the duck envelope toward its target
+    void begin_block(int n) {
+        m_duckMoving = (m_duck != m_duckTarget);
+        if (!m_duckMoving) return;
+        for (int i = 0; i < n; i++) {
+            if (m_duck > m_duckTarget) {
+                m_duck = std::max(m_duckTarget, m_duck - m_duckAttackStep);
+            } else if (m_duck < m_duckTarget) {
+                m_duck = std::min(m_duckTarget, m_duck + m_duckReleaseStep);
+            }
+            m_duckRamp[i] = m_duck;
+        }
+        g_duckGainMilli.store((unsigned int)(m_duck * 1000.0f + 0.5f), std::memory_order_relaxed);
+    }
+
+    // Add a bus into the master mix at its gain (a ducked bus is scaled in place while
+    // the duck envelope moves)
+    void mix_bus(const SynthKernels& k, int bus, float* busLeft, float* busRight, float* left, float* right, int n) {
+        float gain = m_busGain[bus].advance(n);
+        if (MIX_BUS_DUCKED[bus]) {
+            if (m_duckMoving) {
+                k.mul(busLeft, m_duckRamp, n);
+                k.mul(busRight, m_duckRamp, n);
+            } else {
+                gain *= m_duck;
+            }
+        }
+        k.mix_bus(busLeft, busRight, gain, left, right, n);
+    }
+
+    // Master gain, then the limiter
+    void finish(const SynthKernels& k, float* left, float* right, int n) {
+        float master = m_masterGain.advance(n);
+        if (master != 1.0f) {
+            float gain[SYNTH_BLOCK];
+            for (int i = 0; i < n; i++) gain[i] = master;
+            k.mul(left, gain, n);
+            k.mul(right, gain, n);
+        }
+        if (!m_limiterEnabled) return;
+
+        float lowest = m_limiter.process(m_ceiling, left, right, n);
+        if (lowest < 1.0f) {
+            g_limiterFrames.fetch_add(n, std::memory_order_relaxed);
+            unsigned int reductionCdb = (unsigned int)(-2000.0f * log10f(lowest));
+            if (reductionCdb > g_limiterMaxReductionCdb.load(std::memory_order_relaxed)) {
+                g_limiterMaxReductionCdb.store(reductionCdb, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    ParamRamp m_busGain[MIX_BUS_COUNT] = { {1.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 1.0f} };
+    ParamRamp m_masterGain = {1.0f, 1.0f};
+    bool m_limiterEnabled = false;       // Off until the first buffer (reset on enable)
+    float m_ceiling = 1.0f;
+    PeakLimiter m_limiter;
+
+    // Speech ducking envelope (linear gain slopes)
+    float m_duck = 1.0f;
+    float m_duckTarget = 1.0f;
+    float m_duckAttackStep = 0.0f;
+    float m_duckReleaseStep = 0.0f;
+    bool m_duckMoving = false;
+    float m_duckRamp[SYNTH_BLOCK];
+};
+static Mixer g_mixer;
+
+// Clear a bus before its voices render into it
+static inline void clear_bus(float* busLeft, float* busRight, int n) {
+    memset(busLeft, 0, n * sizeof(float));
+    memset(busRight, 0, n * sizeof(float));
+}
+
+// Deadline accounting for one rendered buffer (audio thread only)
+static void record_render_deadline(long long renderStart, unsigned int renderNs, int frameCount) {
+    static long long lastStart = 0;
+    static long long lastPeriodNs = 0;
+
+    long long periodNs = (long long)frameCount * 1000000000LL / g_sampleRate;
+    long long pct = periodNs ? (long long)renderNs * 100 / periodNs : 0;
+    int bucket = 0;
+    while (bucket < RENDER_HIST_BUCKETS - 1 && pct >= RENDER_HIST_EDGES_PCT[bucket]) bucket++;
+    g_audioRenderHist[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (bucket == RENDER_HIST_BUCKETS - 1) g_audioOverruns.fetch_add(1, std::memory_order_relaxed);
+
+    // The device asks for the next buffer about one period after the last; a much later
+    // call means it ran dry in between (or was stalled by the OS)
+    if (lastStart != 0 && renderStart - lastStart > lastPeriodNs * 3 / 2) {
+        g_audioLateCallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+    lastStart = renderStart;
+    lastPeriodNs = periodNs;
+
+    if ((unsigned int)frameCount > g_audioMaxFrames.load(std::memory_order_relaxed)) {
+        g_audioMaxFrames.store((unsigned int)frameCount, std::memory_order_relaxed);
+    }
+}
+
+// Render one device buffer of interleaved stereo: every voice in blocks, the buses
+// mixed and limited. Platform-neutral (the device callback and offline_render call it).
+void render_audio(float* output, int frameCount) {
+    // FAST EXIT if shutting down - zero output and return immediately
+    if (g_shuttingDown.load()) {
+        memset(output, 0, frameCount * 2 * sizeof(float));
+        return;
+    }
+
+    long long renderStart = now_ns();
+    g_renderStartNs = renderStart;
+
+    // Read current parameters once per buffer (consistent across a "frame" command)
+    const ControlSnapshot& ctl = read_control_snapshot();
+    const SynthKernels& k = *g_synth;
+    record_snapshot_latency(ctl);
+
+    int rampSamples = g_paramRampSamples.load(std::memory_order_relaxed);
+    g_aimVoice.begin_buffer(ctl.aim, rampSamples, (int)frameCount, renderStart / 1000,
+                            ctl.spatialMode[SPATIAL_AIM] == SPATIAL_BINAURAL);
+    g_beaconVoice.begin_buffer(ctl.beacon, rampSamples, ctl.spatialMode[SPATIAL_BEACON] == SPATIAL_BINAURAL);
+    g_mixer.begin_buffer(ctl.mixer, rampSamples, renderStart / 1000);
+    apply_radar_reset();
+
+    float left[SYNTH_BLOCK];
+    float right[SYNTH_BLOCK];
+    float busLeft[SYNTH_BLOCK];
+    float busRight[SYNTH_BLOCK];
+    for (int offset = 0; offset < frameCount; offset += SYNTH_BLOCK) {
+        int n = std::min(frameCount - offset, SYNTH_BLOCK);
+        memset(left, 0, n * sizeof(float));
+        memset(right, 0, n * sizeof(float));
+        g_mixer.begin_block(n);
+
+        clear_bus(busLeft, busRight, n);
+        g_aimVoice.render(k, busLeft, busRight, n);
+        g_mixer.mix_bus(k, MIX_BUS_AIM, busLeft, busRight, left, right, n);
+
+        // Vertical lock/unlock blips (one-shot notifications)
+        if (ctl.aim.active) {
+            clear_bus(busLeft, busRight, n);
+            render_blip(g_blipVoice, g_aimBlipPending, k, busLeft, busRight, n);
+            render_blip(g_unlockBlipVoice, g_aimUnlockBlipPending, k, busLeft, busRight, n);
+            g_mixer.mix_bus(k, MIX_BUS_BLIP, busLeft, busRight, left, right, n);
+        }
+
+        // Terrain radar and navigation beacon (can play alongside aim assist)
+        if (ctl.radarActive) {
+            clear_bus(busLeft, busRight, n);
+            render_radar(k, ctl.spatialMode[SPATIAL_RADAR] == SPATIAL_BINAURAL, busLeft, busRight, n);
+            g_mixer.mix_bus(k, MIX_BUS_RADAR, busLeft, busRight, left, right, n);
+        }
+        if (ctl.beacon.active) {
+            clear_bus(busLeft, busRight, n);
+            g_beaconVoice.render(k, busLeft, busRight, n);
+            g_mixer.mix_bus(k, MIX_BUS_BEACON, busLeft, busRight, left, right, n);
+        }
+
+        g_mixer.finish(k, left, right, n);
+        k.interleave(left, right, output + offset * 2, n);
+    }
+
+    // Render cost accounting (single writer: this callback)
+    unsigned int renderNs = (unsigned int)(now_ns() - renderStart);
+    g_audioBuffers.fetch_add(1, std::memory_order_relaxed);
+    g_audioFrames.fetch_add(frameCount, std::memory_order_relaxed);
+    g_audioRenderNs.fetch_add(renderNs, std::memory_order_relaxed);
+    if (renderNs > g_audioRenderMaxNs.load(std::memory_order_relaxed)) {
+        g_audioRenderMaxNs.store(renderNs, std::memory_order_relaxed);
+    }
+    record_render_deadline(renderStart, renderNs, frameCount);
+}
+
+// Full path of a file in the DLL's folder (offline: the working directory)
+static std::string module_file_path(const char* fileName) {
+#ifndef BRIDGE_OFFLINE
+    HMODULE module = NULL;
+    char path[MAX_PATH];
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           (LPCSTR)&module_file_path, &module) &&
+        GetModuleFileNameA(module, path, MAX_PATH) > 0) {
+        char* slash = strrchr(path, '\\');
+        if (slash) {
+            slash[1] = '\0';
+            return std::string(path) + fileName;
+        }
+    }
+#endif
+    return fileName;
+}
+
+#ifndef BRIDGE_OFFLINE
+static DWORD WINAPI worker_thread_proc(LPVOID param) {
+    ((void (*)())param)();
+    // Drop the reference start_worker_thread took; never returns into the DLL
+    HMODULE module = NULL;
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                       (LPCWSTR)&worker_thread_proc, &module);
+    FreeLibraryAndExitThread(module, 0);
+    return 0;
+}
+#endif
+
+// Start a detached worker thread (speech, audio stats CSV). The thread holds a reference
+// on the DLL, taken here before it can run, so a FreeLibrary from the game cannot unmap
+// code the worker is still executing (the DLL then stays loaded until the worker exits).
+static bool start_worker_thread(void (*worker)()) {
+#ifdef BRIDGE_OFFLINE
+    std::thread(worker).detach();
+    return true;
+#else
+    HMODULE module = NULL;
+    if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, (LPCWSTR)&worker_thread_proc, &module)) {
+        return false;
+    }
+    HANDLE thread = CreateThread(NULL, 0, worker_thread_proc, (LPVOID)worker, 0, NULL);
+    if (thread == NULL) {
+        FreeLibrary(module);
+        return false;
+    }
+    CloseHandle(thread);
+    return true;
+#endif
+}
+
+// ============================================================================
+// Audio Device Configuration
+// ============================================================================
+
+// Device settings, loaded once from nvda_arma3_bridge_audio.ini next to the DLL and
+// changed (and saved) by audio_config. One "key=value" per line, '#' or ';' comments:
+//   backend=auto|wasapi|dsound|winmm|null
+//   period_frames=256        frames per device period (0 = backend default, ~10 ms)
+//   periods=2                periods in the device buffer (0 = backend default)
+//   sample_rate=0            0 = the device's own rate (no resampling), else 22050-96000
+//   mode=shared|exclusive    exclusive falls back to shared if the device refuses it
+// Game thread only (like init_audio).
+static const char* AUDIO_CONFIG_NAME = "nvda_arma3_bridge_audio.ini";
+
+enum AudioBackend {
+    AUDIO_BACKEND_AUTO = 0,
+    AUDIO_BACKEND_WASAPI = 1,
+    AUDIO_BACKEND_DSOUND = 2,
+    AUDIO_BACKEND_WINMM = 3,
+    AUDIO_BACKEND_NULL = 4,     // No output (timing tests)
+    AUDIO_BACKEND_COUNT = 5
+};
+static const char* AUDIO_BACKEND_NAMES[AUDIO_BACKEND_COUNT] = { "auto", "wasapi", "dsound", "winmm", "null" };
+
+static const int AUDIO_PERIOD_FRAMES_MAX = 8192;
+static const int AUDIO_PERIODS_MAX = 16;
+
+struct AudioConfig {
+    int backend = AUDIO_BACKEND_AUTO;
+    int periodFrames = 0;       // 0 = backend default
+    int periods = 0;            // 0 = backend default
+    int sampleRate = 0;         // 0 = device rate (offline: SAMPLE_RATE_DEFAULT)
+    bool exclusive = false;
+};
+
+static AudioConfig g_audioConfig;
+static bool g_audioConfigLoaded = false;
+static bool g_audioExclusiveActive = false;  // Open device got exclusive mode
+
+int parse_int(std::string_view str, int defaultVal);  // String Utilities
+
+// Set one config key from its text value; false if the key or value is invalid
+static bool set_audio_config_value(AudioConfig& config, std::string_view key, std::string_view value) {
+    int number = parse_int(value, -1);
+    if (key == "backend") {
+        for (int b = 0; b < AUDIO_BACKEND_COUNT; b++) {
+            if (value == AUDIO_BACKEND_NAMES[b]) {
+                config.backend = b;
+                return true;
+            }
+        }
+        return false;
+    } else if (key == "period_frames") {
+        if (number != 0 && (number < 32 || number > AUDIO_PERIOD_FRAMES_MAX)) return false;
+        config.periodFrames = number;
+    } else if (key == "periods") {
+        if (number < 0 || number > AUDIO_PERIODS_MAX) return false;
+        config.periods = number;
+    } else if (key == "sample_rate") {
+        if (number != 0 && (number < SAMPLE_RATE_MIN || number > SAMPLE_RATE_MAX)) return false;
+        config.sampleRate = number;
+    } else if (key == "mode") {
+        if (value != "shared" && value != "exclusive") return false;
+        config.exclusive = (value == "exclusive");
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Read the config file once (missing file: defaults; bad lines are skipped).
+// Offline renders start from the defaults so they don't depend on the working directory.
+static void load_audio_config() {
+    if (g_audioConfigLoaded) return;
+    g_audioConfigLoaded = true;
+#ifndef BRIDGE_OFFLINE
+    FILE* file = fopen(module_file_path(AUDIO_CONFIG_NAME).c_str(), "r");
+    if (!file) return;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        std::string_view text(line);
+        size_t comment = text.find_first_of("#;\r\n");
+        text = text.substr(0, comment);
+        size_t equals = text.find('=');
+        if (equals == std::string_view::npos) continue;
+        std::string_view key = text.substr(0, equals);
+        std::string_view value = text.substr(equals + 1);
+        while (!key.empty() && key.back() == ' ') key.remove_suffix(1);
+        while (!key.empty() && key.front() == ' ') key.remove_prefix(1);
+        while (!value.empty() && value.back() == ' ') value.remove_suffix(1);
+        while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+        set_audio_config_value(g_audioConfig, key, value);
+    }
+    fclose(file);
+#endif
+}
+
+static bool save_audio_config() {
+    FILE* file = fopen(module_file_path(AUDIO_CONFIG_NAME).c_str(), "w");
+    if (!file) return false;
+    fprintf(file, "# NVDA-Arma 3 Bridge audio device (see audio_config)\n");
+    fprintf(file, "backend=%s\n", AUDIO_BACKEND_NAMES[g_audioConfig.backend]);
+    fprintf(file, "period_frames=%d\n", g_audioConfig.periodFrames);
+    fprintf(file, "periods=%d\n", g_audioConfig.periods);
+    fprintf(file, "sample_rate=%d\n", g_audioConfig.sampleRate);
+    fprintf(file, "mode=%s\n", g_audioConfig.exclusive ? "exclusive" : "shared");
+    fclose(file);
+    return true;
+}
+
+#ifdef BRIDGE_OFFLINE
+// Offline render (render_timeline): one buffer, then the clock moves past it
+void offline_render(float* output, int frameCount) {
+    static long long baseNs = 0;          // Clock at the last rate change
+    static long long renderedFrames = 0;  // Frames since then
+    static int rate = g_sampleRate;
+    if (rate != g_sampleRate) {
+        baseNs += renderedFrames * 1000000000LL / rate;
+        renderedFrames = 0;
+        rate = g_sampleRate;
+    }
+    render_audio(output, frameCount);
+    renderedFrames += frameCount;
+    g_offlineClockNs.store(baseNs + renderedFrames * 1000000000LL / rate, std::memory_order_relaxed);
+}
+
+// Output rate for the harness (set by audio_config:sample_rate)
+int offline_sample_rate() {
+    return g_sampleRate;
+}
+
+// Steady radar tone for one material (RadarVoice waveform without its 25 ms envelope),
+// long enough for the spectral test to resolve aliases next to the harmonics
+void offline_radar_tone(int material, float* output, int frameCount) {
+    RadarVoice voice;
+    RadarBeep beep = { 0.0f, 1.0f, material, 0.0f, 0.0f, 0 };
+    voice.start(beep, false);
+    for (int offset = 0; offset < frameCount; offset += SYNTH_BLOCK) {
+        voice.render_tone(*g_synth, output + offset, std::min(frameCount - offset, SYNTH_BLOCK));
+    }
+}
+#else
+// Audio callback - miniaudio pulls each device buffer from here
+void audio_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
+    (void)pInput;
+    (void)pDevice;
+    render_audio((float*)pOutput, (int)frameCount);
+}
+#endif
+
+#ifndef BRIDGE_OFFLINE
+// Open the device with the config (exclusive: shared if refused); false on failure
+static bool open_audio_device(int sampleRate) {
+    ma_device_config config = ma_device_config_init(ma_device_type_playback);
+    config.playback.format = ma_format_f32;
+    config.playback.channels = 2;  // Stereo for panning
+    config.sampleRate = (ma_uint32)sampleRate;
+    config.periodSizeInFrames = (ma_uint32)g_audioConfig.periodFrames;
+    config.periods = (ma_uint32)g_audioConfig.periods;
+    config.dataCallback = audio_callback;
+    config.pUserData = nullptr;
+
+    g_audioExclusiveActive = false;
+    if (g_audioConfig.exclusive) {
+        config.playback.shareMode = ma_share_mode_exclusive;
+        if (ma_device_init(&g_audioContext, &config, &g_audioDevice) == MA_SUCCESS) {
+            g_audioExclusiveActive = true;
+            return true;
+        }
+        config.playback.shareMode = ma_share_mode_shared;
+    }
+    return ma_device_init(&g_audioContext, &config, &g_audioDevice) == MA_SUCCESS;
+}
+#endif
+
+// Initialize audio device (offline: nothing to open, offline_render pulls buffers)
+bool init_audio() {
+    if (g_audioInitialized) {
+        return true;
+    }
+    load_audio_config();
+
+#ifdef BRIDGE_OFFLINE
+    if (set_sample_rate(g_audioConfig.sampleRate ? g_audioConfig.sampleRate : SAMPLE_RATE_DEFAULT)) {
+        g_mixer.reset_limiter();
+    }
+#else
+    static const ma_backend BACKENDS[AUDIO_BACKEND_COUNT] = {
+        ma_backend_null /* auto: miniaudio's own order */, ma_backend_wasapi, ma_backend_dsound, ma_backend_winmm, ma_backend_null
+    };
+    ma_result contextResult = (g_audioConfig.backend == AUDIO_BACKEND_AUTO)
+        ? ma_context_init(nullptr, 0, nullptr, &g_audioContext)
+        : ma_context_init(&BACKENDS[g_audioConfig.backend], 1, nullptr, &g_audioContext);
+    if (contextResult != MA_SUCCESS) {
+        return false;
+    }
+
+    if (!open_audio_device(g_audioConfig.sampleRate)) {
+        ma_context_uninit(&g_audioContext);
+        return false;
+    }
+    // The synth renders at the device's rate; one outside its range is resampled instead
+    if ((int)g_audioDevice.sampleRate < SAMPLE_RATE_MIN || (int)g_audioDevice.sampleRate > SAMPLE_RATE_MAX) {
+        ma_device_uninit(&g_audioDevice);
+        if (!open_audio_device(SAMPLE_RATE_DEFAULT)) {
+            ma_context_uninit(&g_audioContext);
+            return false;
+        }
+    }
+    if (set_sample_rate((int)g_audioDevice.sampleRate)) {
+        g_mixer.reset_limiter();
+    }
+
+    if (ma_device_start(&g_audioDevice) != MA_SUCCESS) {
+        ma_device_uninit(&g_audioDevice);
+        ma_context_uninit(&g_audioContext);
+        return false;
+    }
+    g_devicePeriodFrames.store(g_audioDevice.playback.internalPeriodSizeInFrames);
+    g_devicePeriods.store(g_audioDevice.playback.internalPeriods);
+    g_deviceSampleRate.store(g_audioDevice.playback.internalSampleRate);
+#endif
+
+    g_audioInitialized = true;
+    return true;
+}
+
+// Close the device and open it again with the current config (audio_config).
+// Offline there is no device: the new rate takes effect at once.
+static bool reopen_audio() {
+#ifndef BRIDGE_OFFLINE
+    if (!g_audioInitialized) return true;  // The next *_start opens it
+    ma_device_uninit(&g_audioDevice);      // Stops the callback first
+    ma_context_uninit(&g_audioContext);
+    g_devicePeriodFrames.store(0);
+    g_devicePeriods.store(0);
+    g_deviceSampleRate.store(0);
+#endif
+    g_audioInitialized = false;
+    return init_audio();
+}
+
+// Shutdown audio device
+void shutdown_audio() {
+    if (g_audioInitialized) {
+        g_shuttingDown.store(true);
+        AimParams aim = g_aimParams.get();
+        aim.active = false;
+        aim.muted = true;
+        g_aimParams.publish(aim);
+
+#ifndef BRIDGE_OFFLINE
+        // Just stop the device, don't uninitialize
+        // Let the OS clean up on process exit to avoid deadlock
+        ma_device_stop(&g_audioDevice);
+#endif
+
+        // DON'T call ma_device_uninit() - it can deadlock during shutdown
+        // g_audioInitialized stays true but that's fine, process is exiting
+    }
+}
+
+// ============================================================================
+// String Utilities
+// ============================================================================
+
+// Convert UTF-8 string to wide string (UTF-16)
+std::wstring utf8_to_wstring(std::string_view str) {
+    if (str.empty()) return std::wstring();
+
+    int size_needed = MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.length(), NULL, 0);
+    if (size_needed <= 0) return std::wstring();
+
+    std::wstring result(size_needed, 0);
+    MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.length(), &result[0], size_needed);
+    return result;
+}
+
+// Convert wide string (UTF-16) to UTF-8 into a fixed buffer (truncates, always terminated)
+void wstring_to_utf8(const wchar_t* str, char* out, int outSize) {
+    if (!out || outSize <= 0) return;
+    out[0] = '\0';
+    if (!str || !*str) return;
+
+    int written = WideCharToMultiByte(CP_UTF8, 0, str, -1, out, outSize, NULL, NULL);
+    if (written <= 0) {
+        // Buffer too small - WideCharToMultiByte writes nothing, so fall back to ASCII
+        int i = 0;
+        for (; str[i] && i < outSize - 1; i++) out[i] = (str[i] < 128) ? (char)str[i] : '?';
+        out[i] = '\0';
+    }
+}
+
+// Safe string copy to output buffer
+void safe_output(char* output, int outputSize, const char* str) {
+    if (output && outputSize > 0 && str) {
+        strncpy_s(output, outputSize, str, _TRUNCATE);
+    }
+}
+
+// Strip the quotes Arma adds around string arguments in RVExtensionArgs ("text" -> text, "" -> ")
+std::string unquote_arg(const char* arg) {
+    if (!arg) return std::string();
+    size_t len = strlen(arg);
+    if (len < 2 || arg[0] != '"' || arg[len - 1] != '"') return std::string(arg, len);
+
+    std::string result;
+    result.reserve(len - 2);
+    for (size_t i = 1; i < len - 1; i++) {
+        result += arg[i];
+        if (arg[i] == '"' && arg[i + 1] == '"' && i + 1 < len - 1) i++;
+    }
+    return result;
+}
+
+// Parse float in place (no allocation); defaultVal if empty or not a number
+float parse_float(std::string_view str, float defaultVal) {
+    while (!str.empty() && str.front() == ' ') str.remove_prefix(1);
+    float val;
+    std::from_chars_result res = std::from_chars(str.data(), str.data() + str.size(), val);
+    return (res.ec == std::errc() && res.ptr != str.data()) ? val : defaultVal;
+}
+
+// Parse int in place (no allocation); defaultVal if empty or not a number
+int parse_int(std::string_view str, int defaultVal) {
+    while (!str.empty() && str.front() == ' ') str.remove_prefix(1);
+    int val;
+    std::from_chars_result res = std::from_chars(str.data(), str.data() + str.size(), val);
+    return (res.ec == std::errc() && res.ptr != str.data()) ? val : defaultVal;
+}
+
+// Parse float strictly: false if empty or not entirely a number (typed args protocol)
+bool try_parse_float(std::string_view str, float& val) {
+    while (!str.empty() && str.front() == ' ') str.remove_prefix(1);
+    std::from_chars_result res = std::from_chars(str.data(), str.data() + str.size(), val);
+    return res.ec == std::errc() && res.ptr == str.data() + str.size() && !str.empty();
+}
+
+// View of an RVExtensionArgs string argument without Arma's surrounding quotes
+// (embedded "" escapes are left as-is; use unquote_arg when they matter)
+std::string_view arg_view(const char* arg) {
+    std::string_view view(arg ? arg : "");
+    if (view.size() >= 2 && view.front() == '"' && view.back() == '"') {
+        view = view.substr(1, view.size() - 2);
+    }
+    return view;
+}
+
+// Split off the next comma-separated field and advance rest past it
+// ("1,2,3" -> "1", rest = "2,3"; the last field leaves rest empty)
+std::string_view next_field(std::string_view& rest) {
+    size_t comma = rest.find(',');
+    std::string_view field = rest.substr(0, comma);
+    rest = (comma == std::string_view::npos) ? std::string_view() : rest.substr(comma + 1);
+    return field;
+}
+
+// Split an SQF array literal, as Arma passes a nested array argument, into its
+// top-level elements in place: separators are overwritten with '\0' and strings keep
+// their quotes, so elements read like ordinary RVExtensionArgs arguments.
+// Returns the element count, or -1 if text is not an array or has too many elements.
+int split_sqf_array(char* text, const char** elements, int maxElements) {
+    char* p = text;
+    while (*p == ' ') p++;
+    if (*p != '[') return -1;
+    p++;
+
+    int count = 0;
+    for (;;) {
+        while (*p == ' ') p++;
+        if (*p == ']' && count == 0) return 0;  // Empty array
+        if (*p == '\0' || count == maxElements) return -1;
+
+        char* start = p;
+        int depth = 0;
+        while (*p != '\0') {
+            if (*p == '"') {
+                // String: "" is an escaped quote, a lone " ends it
+                p++;
+                while (*p != '\0' && !(p[0] == '"' && p[1] != '"')) p += (*p == '"') ? 2 : 1;
+                if (*p == '\0') return -1;
+            } else if (*p == '[') {
+                depth++;
+            } else if (*p == ']' || *p == ',') {
+                if (depth == 0) break;
+                if (*p == ']') depth--;
+            }
+            p++;
+        }
+        if (*p == '\0') return -1;  // Unterminated array
+
+        char* end = p;
+        while (end > start && end[-1] == ' ') end--;
+        bool last = (*p == ']');
+        *end = '\0';
+        elements[count++] = start;
+        if (last) return count;
+        p++;
+    }
+}
+
+// ============================================================================
+// Radar Material Classification (game thread)
+// ============================================================================
+
+// radar_beep and radar_sweep_hit take the raw surface SQF reports for a hit: a terrain
+// surface ("#GdtGrassGreen") or an object's penetration material path
+// ("a3\data_f\penetration\metal_plate.bisurf", looked up by its base name "metal_plate").
+// A "|kind" suffix (man, building, tree, vehicle: from isKindOf) says what object was
+// hit; man always wins, the others only when the surface says nothing. The plain
+// material names (grass, concrete, ..., none) are surfaces too.
+//
+// Known surfaces resolve through a hash table built at compile time. Anything else is
+// classified by keyword (the rules the SQF radar used) and kept in a small LRU cache,
+// since a sweep hits the same few surfaces over and over.
+
+struct KnownSurface {
+    std::string_view name;      // Lowercase
+    int material;
+};
+
+static constexpr KnownSurface KNOWN_SURFACES[] = {
+    // Plain material names (radar_beep's original vocabulary)
+    { "none",                 MATERIAL_NONE },
+    { "default",              MATERIAL_DEFAULT },
+    { "grass",                MATERIAL_GRASS },
+    { "soil",                 MATERIAL_GRASS },
+    { "sand",                 MATERIAL_GRASS },
+    { "dirt",                 MATERIAL_GRASS },
+    { "concrete",             MATERIAL_CONCRETE },
+    { "asphalt",              MATERIAL_CONCRETE },
+    { "rock",                 MATERIAL_CONCRETE },
+    { "stone",                MATERIAL_CONCRETE },
+    { "wood",                 MATERIAL_WOOD },
+    { "wood_planks",          MATERIAL_WOOD },
+    { "metal",                MATERIAL_METAL },
+    { "metal_plate",          MATERIAL_METAL },
+    { "water",                MATERIAL_WATER },
+    { "man",                  MATERIAL_MAN },
+    { "glass",                MATERIAL_GLASS },
+
+    // Object penetration materials (a3\data_f\penetration\*.bisurf)
+    { "armour",               MATERIAL_METAL },
+    { "armour_plate",         MATERIAL_METAL },
+    { "armour_plate_thin",    MATERIAL_METAL },
+    { "metal_plate_thin",     MATERIAL_METAL },
+    { "building",             MATERIAL_CONCRETE },
+    { "concrete_plate",       MATERIAL_CONCRETE },
+    { "plaster",              MATERIAL_CONCRETE },
+    { "wood_plank",           MATERIAL_WOOD },
+    { "wood_int",             MATERIAL_WOOD },
+    { "glass_armored",        MATERIAL_GLASS },
+    { "body",                 MATERIAL_MAN },
+    { "plastic",              MATERIAL_DEFAULT },
+    { "rubber",               MATERIAL_DEFAULT },
+    { "tyre",                 MATERIAL_DEFAULT },
+    { "cloth",                MATERIAL_DEFAULT },
+
+    // Altis and VR terrain
+    { "#gdtrock",             MATERIAL_CONCRETE },
+    { "#gdtstony",            MATERIAL_CONCRETE },
+    { "#gdtconcrete",         MATERIAL_CONCRETE },
+    { "#gdtasphalt",          MATERIAL_CONCRETE },
+    { "#gdtsoil",             MATERIAL_GRASS },
+    { "#gdtdirt",             MATERIAL_GRASS },
+    { "#gdtgrassgreen",       MATERIAL_GRASS },
+    { "#gdtgrassdry",         MATERIAL_GRASS },
+    { "#gdtgrasswild",        MATERIAL_GRASS },
+    { "#gdtwildfield",        MATERIAL_GRASS },
+    { "#gdtthorn",            MATERIAL_GRASS },
+    { "#gdtdead",             MATERIAL_GRASS },
+    { "#gdtdesert",           MATERIAL_GRASS },
+    { "#gdtmarsh",            MATERIAL_GRASS },
+    { "#gdtbeach",            MATERIAL_GRASS },
+    { "#gdtseabed",           MATERIAL_GRASS },
+    { "#gdtforestpine",       MATERIAL_GRASS },
+    { "#gdtvrsurface01",      MATERIAL_GRASS },
+
+    // Stratis terrain
+    { "#gdtstratisconcrete",  MATERIAL_CONCRETE },
+    { "#gdtstratisrocky",     MATERIAL_CONCRETE },
+    { "#gdtstratisdrygrass",  MATERIAL_GRASS },
+    { "#gdtstratisgreengrass", MATERIAL_GRASS },
+    { "#gdtstratisforestpine", MATERIAL_GRASS },
+    { "#gdtstratisthistles",  MATERIAL_GRASS },
+    { "#gdtstratisdirt",      MATERIAL_GRASS },
+    { "#gdtstratisbeach",     MATERIAL_GRASS },
+    { "#gdtstratisseabed",    MATERIAL_GRASS },
+
+    // Chernarus-style terrain (Arma 2 ports)
+    { "#crgrass1",            MATERIAL_GRASS },
+    { "#crgrass2",            MATERIAL_GRASS },
+    { "#crgrassw1",           MATERIAL_GRASS },
+    { "#crgrassw2",           MATERIAL_GRASS },
+    { "#crforest1",           MATERIAL_GRASS },
+    { "#crforest2",           MATERIAL_GRASS },
+    { "#crheather",           MATERIAL_GRASS },
+    { "#crdirt",              MATERIAL_GRASS },
+    { "#crtarmac",            MATERIAL_CONCRETE },
+    { "#crconcrete",          MATERIAL_CONCRETE },
+    { "#crboulders",          MATERIAL_CONCRETE },
+    { "#crstony",             MATERIAL_CONCRETE },
+};
+static const int KNOWN_SURFACE_COUNT = (int)(sizeof(KNOWN_SURFACES) / sizeof(KNOWN_SURFACES[0]));
+
+// FNV-1a (lowercase input)
+static constexpr uint32_t surface_hash(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    return hash;
+}
+
+// Open addressing, linear probing; slots hold KNOWN_SURFACES indices (-1 = empty)
+static const int SURFACE_HASH_SIZE = 256;  // Power of 2, at least twice the entries
+static_assert(KNOWN_SURFACE_COUNT * 2 <= SURFACE_HASH_SIZE, "SURFACE_HASH_SIZE too small");
+
+struct SurfaceHashTable {
+    int16_t slots[SURFACE_HASH_SIZE];
+};
+
+static constexpr SurfaceHashTable build_surface_table() {
+    SurfaceHashTable table = {};
+    for (int i = 0; i < SURFACE_HASH_SIZE; i++) table.slots[i] = -1;
+    for (int e = 0; e < KNOWN_SURFACE_COUNT; e++) {
+        uint32_t slot = surface_hash(KNOWN_SURFACES[e].name) & (SURFACE_HASH_SIZE - 1);
+        while (table.slots[slot] >= 0) slot = (slot + 1) & (SURFACE_HASH_SIZE - 1);
+        table.slots[slot] = (int16_t)e;
+    }
+    return table;
+}
+static constexpr SurfaceHashTable SURFACE_TABLE = build_surface_table();
+
+static constexpr bool known_surfaces_unique() {
+    for (int i = 0; i < KNOWN_SURFACE_COUNT; i++) {
+        for (int j = i + 1; j < KNOWN_SURFACE_COUNT; j++) {
+            if (KNOWN_SURFACES[i].name == KNOWN_SURFACES[j].name) return false;
+        }
+    }
+    return true;
+}
+static_assert(known_surfaces_unique(), "KNOWN_SURFACES has a duplicate name");
+
+// Material of a known surface, or false
+static bool find_known_surface(std::string_view name, uint32_t hash, int& material) {
+    uint32_t slot = hash & (SURFACE_HASH_SIZE - 1);
+    for (int index = SURFACE_TABLE.slots[slot]; index >= 0; index = SURFACE_TABLE.slots[slot]) {
+        if (KNOWN_SURFACES[index].name == name) {
+            material = KNOWN_SURFACES[index].material;
+            return true;
+        }
+        slot = (slot + 1) & (SURFACE_HASH_SIZE - 1);
+    }
+    return false;
+}
+
+// Keyword rules for unknown surfaces (same order as the old SQF chain)
+static int classify_surface_keywords(std::string_view name) {
+    auto has = [name](const char* word) { return name.find(word) != std::string_view::npos; };
+    if (has("grass") || has("soil") || has("sand") || has("dirt") || has("gdt")) {
+        // Terrain ("gdt" catches #Gdt* types): rocky ground sounds hard, the rest soft
+        return (has("rock") || has("stone") || has("gravel")) ? MATERIAL_CONCRETE : MATERIAL_GRASS;
+    }
+    if (has("concrete") || has("asphalt") || has("rock") || has("stone")) return MATERIAL_CONCRETE;
+    if (has("wood") || has("plank")) return MATERIAL_WOOD;
+    if (has("metal") || has("iron") || has("steel")) return MATERIAL_METAL;
+    if (has("water")) return MATERIAL_WATER;
+    if (has("glass")) return MATERIAL_GLASS;
+    return MATERIAL_DEFAULT;
+}
+
+// LRU cache of keyword-classified surfaces: 4-way set associative, least recently used
+// way replaced. Names longer than a slot are classified every time.
+static const int SURFACE_CACHE_SETS = 32;   // Power of 2
+static const int SURFACE_CACHE_WAYS = 4;
+static const int SURFACE_CACHE_NAME = 64;
+
+struct SurfaceCacheEntry {
+    uint32_t hash;
+    uint32_t lastUse;           // 0 = empty
+    int8_t material;
+    uint8_t length;
+    char name[SURFACE_CACHE_NAME];
+};
+static SurfaceCacheEntry g_surfaceCache[SURFACE_CACHE_SETS][SURFACE_CACHE_WAYS];
+static uint32_t g_surfaceCacheClock = 0;
+static unsigned int g_surfaceCacheHits = 0;
+static unsigned int g_surfaceCacheMisses = 0;
+
+static int classify_unknown_surface(std::string_view name, uint32_t hash) {
+    if (name.size() > SURFACE_CACHE_NAME) return classify_surface_keywords(name);
+
+    SurfaceCacheEntry* set = g_surfaceCache[hash & (SURFACE_CACHE_SETS - 1)];
+    SurfaceCacheEntry* oldest = &set[0];
+    for (int way = 0; way < SURFACE_CACHE_WAYS; way++) {
+        SurfaceCacheEntry& entry = set[way];
+        if (entry.lastUse != 0 && entry.hash == hash && entry.length == name.size() &&
+            memcmp(entry.name, name.data(), name.size()) == 0) {
+            entry.lastUse = ++g_surfaceCacheClock;
+            g_surfaceCacheHits++;
+            return entry.material;
+        }
+        if (entry.lastUse < oldest->lastUse) oldest = &entry;
+    }
+
+    g_surfaceCacheMisses++;
+    int material = classify_surface_keywords(name);
+    oldest->hash = hash;
+    oldest->lastUse = ++g_surfaceCacheClock;
+    oldest->material = (int8_t)material;
+    oldest->length = (uint8_t)name.size();
+    memcpy(oldest->name, name.data(), name.size());
+    return material;
+}
+
+// Raw surface (optionally "|kind") -> RadarMaterial
+static int classify_material(std::string_view material) {
+    std::string_view kind;
+    size_t bar = material.find('|');
+    if (bar != std::string_view::npos) {
+        kind = material.substr(bar + 1);
+        material = material.substr(0, bar);
+    }
+
+    // Penetration material paths: the file's base name
+    size_t slash = material.find_last_of("\\/");
+    if (slash != std::string_view::npos) material = material.substr(slash + 1);
+
+    // Lowercase copy (longer names are cut; nothing known is that long)
+    char lower[128];
+    size_t length = (material.size() < sizeof(lower)) ? material.size() : sizeof(lower);
+    for (size_t i = 0; i < length; i++) {
+        char c = material[i];
+        lower[i] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+    std::string_view name(lower, length);
+    static const std::string_view SURFACE_FILE_EXT = ".bisurf";
+    if (name.size() > SURFACE_FILE_EXT.size() &&
+        name.substr(name.size() - SURFACE_FILE_EXT.size()) == SURFACE_FILE_EXT) {
+        name.remove_suffix(SURFACE_FILE_EXT.size());
+    }
+
+    int code = MATERIAL_DEFAULT;
+    uint32_t hash = surface_hash(name);
+    if (!find_known_surface(name, hash, code) && !name.empty()) {
+        code = classify_unknown_surface(name, hash);
+    }
+
+    if (kind == "man") return MATERIAL_MAN;
+    if (code == MATERIAL_DEFAULT) {
+        if (kind == "building") return MATERIAL_CONCRETE;
+        if (kind == "tree") return MATERIAL_WOOD;
+        if (kind == "vehicle") return MATERIAL_METAL;
+    }
+    return code;
+}
+
+// ============================================================================
+// Speech Dispatcher (NVDA RPC worker thread)
+// ============================================================================
+
+// Queued NVDA operations
+enum SpeechCommandType {
+    SPEECH_CMD_SPEAK = 0,
+    SPEECH_CMD_CANCEL = 1,
+    SPEECH_CMD_BRAILLE = 2,
+    SPEECH_CMD_SSML = 3     // Structured speech, rendered to SSML by the worker
+};
+
+// Scheduling policy:
+//   - Priority classes follow NVDA's SPEECH_PRIORITY (NORMAL < NEXT < NOW).
+//     Higher classes are sent first; NOW also interrupts whatever NVDA is saying.
+//   - Speech with a non-empty key replaces any unsent speech with the same key
+//     (keeps its place in line, takes the newer text and timestamp).
+//   - Speech older than its max age when it reaches the front is dropped.
+struct SpeechCommand {
+    int type;
+    std::wstring text;
+    int priority;           // SPEECH_PRIORITY_NORMAL / _NEXT / _NOW
+    std::string key;        // Coalescing key ("" = never coalesce)
+    long long queuedAt;     // now_us() when queued
+    long long maxAgeUs;     // Drop if not sent within this time (0 = never stale)
+
+    // SSML prosody (SPEECH_CMD_SSML only)
+    int rateBoost;          // Percent added to speaking rate (0 = unchanged)
+    int pitchBoost;         // Percent added to pitch (0 = unchanged)
+    std::wstring mark;      // <mark> name appended after the text ("" = none)
+};
+
+static bool is_speech_command(int type) {
+    return type == SPEECH_CMD_SPEAK || type == SPEECH_CMD_SSML;
+}
+
+// Ring buffer of pending NVDA calls (producer: command handler, consumer: speech worker)
+static const int SPEECH_QUEUE_SIZE = 64;  // Holds SPEECH_QUEUE_SIZE - 1 pending commands
+static SpeechCommand g_speechQueue[SPEECH_QUEUE_SIZE];
+static std::atomic<int> g_speechQueueHead(0);  // Next write position (command handler)
+static std::atomic<int> g_speechQueueTail(0);  // Next read position (speech worker)
+
+// Commands moved out of the ring and waiting to be scheduled (speech worker only)
+static const int SPEECH_PENDING_MAX = 128;
+static std::vector<SpeechCommand> g_speechPending;
+
+// NvdaController2 (speakSsml) availability: -1 = not yet detected, 0 = missing, 1 = available
+static std::atomic<int> g_nvdaSsmlSupport(-1);
+
+// Worker thread state
+static bool g_speechInitialized = false;
+static HANDLE g_speechWakeEvent = NULL;        // Auto-reset event, signalled on enqueue and when a lane frees
+static std::atomic<bool> g_speechShutdown(false);
+
+// SSML lanes. speakSsml is called with asynchronous = FALSE: NVDA's mark callback is an
+// RPC callback, delivered only while the call carrying the mark is in flight. That call
+// lasts as long as the utterance, so it runs on a lane thread while the worker keeps
+// sending cancels, braille and interrupting speech. The queued lane speaks normal/next
+// SSML in order; the NOW lane speaks over it (NVDA pauses the queued utterance).
+enum SpeechLaneId { SPEECH_LANE_QUEUED = 0, SPEECH_LANE_NOW = 1, SPEECH_LANE_COUNT = 2 };
+struct SpeechLane {
+    HANDLE wakeEvent = NULL;           // Auto-reset event, signalled when a call is handed over
+    std::atomic<bool> busy{false};     // Call handed over and not yet returned
+    std::wstring ssml;                 // Written by the worker while the lane is idle
+    SPEECH_PRIORITY priority = SPEECH_PRIORITY_NORMAL;
+};
+static SpeechLane g_speechLanes[SPEECH_LANE_COUNT];
+
+// Statistics
+static std::atomic<int> g_speechPendingDepth(0);        // Size of g_speechPending
+static std::atomic<unsigned int> g_speechQueued(0);     // Commands accepted into the queue
+static std::atomic<unsigned int> g_speechSpoken(0);     // speakText calls made
+static std::atomic<unsigned int> g_speechSsml(0);       // speakSsml calls made
+static std::atomic<unsigned int> g_speechSsmlFallback(0); // SSML speech sent as plain text
+static std::atomic<unsigned int> g_speechBrailled(0);   // brailleMessage calls made
+static std::atomic<unsigned int> g_speechCancels(0);    // cancelSpeech calls made (incl. interrupts)
+static std::atomic<unsigned int> g_speechInterrupts(0); // NOW-priority speech that interrupted NVDA
+static std::atomic<unsigned int> g_speechSkipped(0);    // Speech discarded by a later cancel
+static std::atomic<unsigned int> g_speechCoalesced(0);  // Speech replaced by newer speech with same key
+static std::atomic<unsigned int> g_speechStale(0);      // Speech dropped for exceeding its max age
+static std::atomic<unsigned int> g_speechOverflow(0);   // Speech dropped because pending list was full
+static std::atomic<unsigned int> g_speechFull(0);       // Commands rejected (queue full)
+static std::atomic<unsigned int> g_speechErrors(0);     // Non-zero RPC results
+
+// RPC latency history (microseconds, most recent SPEECH_LATENCY_HISTORY calls)
+static const int SPEECH_LATENCY_HISTORY = 256;
+static std::atomic<unsigned int> g_speechLatencyUs[SPEECH_LATENCY_HISTORY];
+static std::atomic<unsigned int> g_speechLatencyCount(0);
+
+// Parse a priority argument: "now", "next", "normal" or 0-2
+int parse_speech_priority(const char* str) {
+    if (!str || !*str) return SPEECH_PRIORITY_NORMAL;
+    if (_stricmp(str, "now") == 0) return SPEECH_PRIORITY_NOW;
+    if (_stricmp(str, "next") == 0) return SPEECH_PRIORITY_NEXT;
+    int val = parse_int(str, SPEECH_PRIORITY_NORMAL);
+    return (val < SPEECH_PRIORITY_NORMAL) ? SPEECH_PRIORITY_NORMAL : (val > SPEECH_PRIORITY_NOW) ? SPEECH_PRIORITY_NOW : val;
+}
+
+// Time a single NVDA RPC and record its round-trip latency
+static void speech_record_latency(long long start, error_status_t result) {
+    if (result != 0) {
+        g_speechErrors.fetch_add(1);
+    }
+
+    long long elapsed = now_us() - start;
+    unsigned int slot = g_speechLatencyCount.fetch_add(1) % SPEECH_LATENCY_HISTORY;
+    g_speechLatencyUs[slot].store((unsigned int)(elapsed > 0 ? elapsed : 0), std::memory_order_relaxed);
+}
+
+// Detect NvdaController2 once: getProcessId only exists on that interface.
+// Stays undetected while NVDA is not running so a later start is still picked up.
+static bool nvda_supports_ssml() {
+    int support = g_nvdaSsmlSupport.load();
+    if (support < 0) {
+        unsigned long pid = 0;
+        if (nvdaController_getProcessId(&pid) == 0) {
+            support = 1;
+        } else if (nvdaController_testIfRunning() == 0) {
+            support = 0;
+        }
+        if (support >= 0) g_nvdaSsmlSupport.store(support);
+    }
+    return support == 1;
+}
+
+// Append text with the five XML special characters escaped
+static void append_xml_escaped(std::wstring& out, const std::wstring& text) {
+    for (wchar_t c : text) {
+        switch (c) {
+            case L'&': out += L"&amp;"; break;
+            case L'<': out += L"&lt;"; break;
+            case L'>': out += L"&gt;"; break;
+            case L'"': out += L"&quot;"; break;
+            case L'\'': out += L"&apos;"; break;
+            default: out += c; break;
+        }
+    }
+}
+
+// Hidden completion mark appended to SSML speech for ducking (never raised to SQF)
+static const wchar_t* const SPEECH_DONE_MARK_PREFIX = L"nvda_arma3_bridge_done_";
+static std::atomic<unsigned int> g_speechSentSeq(0);   // Utterances sent (worker only writes)
+
+// Render a structured speech command as SSML
+// e.g. <speak><prosody rate="130%" pitch="115%">50 meters</prosody><mark name="enemy"/></speak>
+// doneSeq != 0 appends the hidden completion mark for that utterance
+static std::wstring build_ssml(const SpeechCommand& item, unsigned int doneSeq = 0) {
+    std::wstring ssml = L"<speak>";
+    bool prosody = (item.rateBoost != 0 || item.pitchBoost != 0);
+
+    if (prosody) {
+        wchar_t attrs[64];
+        swprintf(attrs, 64, L"<prosody rate=\"%d%%\" pitch=\"%d%%\">", 100 + item.rateBoost, 100 + item.pitchBoost);
+        ssml += attrs;
+    }
+    append_xml_escaped(ssml, item.text);
+    if (prosody) {
+        ssml += L"</prosody>";
+    }
+    if (!item.mark.empty()) {
+        ssml += L"<mark name=\"";
+        append_xml_escaped(ssml, item.mark);
+        ssml += L"\"/>";
+    }
+    if (doneSeq != 0) {
+        ssml += L"<mark name=\"";
+        ssml += SPEECH_DONE_MARK_PREFIX;
+        ssml += std::to_wstring(doneSeq);
+        ssml += L"\"/>";
+    }
+    ssml += L"</speak>";
+    return ssml;
+}
+
+// Extend the expected end of speech by one utterance (ducking). An interrupting
+// utterance replaces what was playing; otherwise NVDA queues it after the current speech.
+// Returns the utterance's sequence number.
+static unsigned int speech_note_sent(const SpeechCommand& item, bool interrupts) {
+    long long now = now_us();
+    int cps = g_speechCharsPerSec.load(std::memory_order_relaxed);
+    long long durationUs = (long long)item.text.size() * 1000000 / ((cps > 0) ? cps : SPEECH_CPS_DEFAULT);
+    if (item.type == SPEECH_CMD_SSML) {
+        durationUs = durationUs * 100 / (100 + item.rateBoost);  // Prosody rate (boost clamped to -50..100)
+    }
+    long long busyUntil = g_speechBusyUntilUs.load(std::memory_order_relaxed);
+    long long start = (interrupts || busyUntil < now) ? now : busyUntil;
+    g_speechBusyUntilUs.store(start + durationUs, std::memory_order_relaxed);
+    return g_speechSentSeq.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// Run one scheduled NVDA call
+static void speech_execute(const SpeechCommand& item) {
+    long long start;
+
+    // NVDA versions without NvdaController2 get the plain text (prosody and mark are lost)
+    int type = item.type;
+    if (type == SPEECH_CMD_SSML && !nvda_supports_ssml()) {
+        type = SPEECH_CMD_SPEAK;
+        g_speechSsmlFallback.fetch_add(1);
+    }
+
+    switch (type) {
+        case SPEECH_CMD_SPEAK:
+            if (item.priority == SPEECH_PRIORITY_NOW) {
+                // Interrupt: cut off whatever NVDA is currently saying
+                start = now_us();
+                speech_record_latency(start, nvdaController_cancelSpeech());
+                g_speechCancels.fetch_add(1);
+                g_speechInterrupts.fetch_add(1);
+            }
+            speech_note_sent(item, item.priority == SPEECH_PRIORITY_NOW);
+            g_speechDoneSeq.store(0);  // Plain text has no completion mark: the estimate decides
+            start = now_us();
+            speech_record_latency(start, nvdaController_speakText(item.text.c_str()));
+            g_speechSpoken.fetch_add(1);
+            break;
+        case SPEECH_CMD_SSML:
+            {
+                // NVDA applies the priority itself (NOW pauses and later resumes current speech,
+                // so its completion mark does not mean NVDA has gone quiet)
+                bool pausesOthers = item.priority == SPEECH_PRIORITY_NOW &&
+                                    g_speechBusyUntilUs.load(std::memory_order_relaxed) > now_us();
+                unsigned int seq = speech_note_sent(item, false);
+                g_speechDoneSeq.store(pausesOthers ? 0 : seq);
+
+                // Hand the call to its lane (idle: speech_can_send checked it). Not in the
+                // RPC latency history, since the call lasts the whole utterance.
+                SpeechLane& lane = g_speechLanes[(item.priority == SPEECH_PRIORITY_NOW) ? SPEECH_LANE_NOW : SPEECH_LANE_QUEUED];
+                lane.ssml = build_ssml(item, seq);
+                lane.priority = (SPEECH_PRIORITY)item.priority;
+                lane.busy.store(true, std::memory_order_release);
+                SetEvent(lane.wakeEvent);
+                g_speechSsml.fetch_add(1);
+            }
+            break;
+        case SPEECH_CMD_CANCEL:
+            start = now_us();
+            speech_record_latency(start, nvdaController_cancelSpeech());
+            g_speechCancels.fetch_add(1);
+            g_speechBusyUntilUs.store(now_us(), std::memory_order_relaxed);  // Silent now (hold still applies)
+            break;
+        case SPEECH_CMD_BRAILLE:
+            start = now_us();
+            speech_record_latency(start, nvdaController_brailleMessage(item.text.c_str()));
+            g_speechBrailled.fetch_add(1);
+            break;
+    }
+}
+
+// Move everything from the ring into the pending list, applying cancel and coalescing
+// Returns true if a cancel was seen (caller sends it before any remaining speech)
+static bool speech_drain_queue() {
+    bool cancelSeen = false;
+
+    int tail = g_speechQueueTail.load(std::memory_order_relaxed);
+    while (tail != g_speechQueueHead.load(std::memory_order_acquire)) {
+        SpeechCommand& item = g_speechQueue[tail];
+
+        if (item.type == SPEECH_CMD_CANCEL) {
+            // Drop all unsent speech queued before the cancel (braille is unaffected)
+            size_t kept = 0;
+            for (size_t i = 0; i < g_speechPending.size(); i++) {
+                if (is_speech_command(g_speechPending[i].type)) {
+                    g_speechSkipped.fetch_add(1);
+                } else {
+                    g_speechPending[kept++] = std::move(g_speechPending[i]);
+                }
+            }
+            g_speechPending.resize(kept);
+            cancelSeen = true;
+        } else {
+            bool coalesced = false;
+            if (is_speech_command(item.type) && !item.key.empty()) {
+                for (SpeechCommand& pending : g_speechPending) {
+                    if (is_speech_command(pending.type) && pending.key == item.key) {
+                        pending = std::move(item);
+                        g_speechCoalesced.fetch_add(1);
+                        coalesced = true;
+                        break;
+                    }
+                }
+            }
+
+            if (!coalesced) {
+                if ((int)g_speechPending.size() >= SPEECH_PENDING_MAX) {
+                    // Make room by dropping the oldest lowest-priority command
+                    size_t victim = 0;
+                    for (size_t i = 1; i < g_speechPending.size(); i++) {
+                        if (g_speechPending[i].priority < g_speechPending[victim].priority) victim = i;
+                    }
+                    g_speechPending.erase(g_speechPending.begin() + victim);
+                    g_speechOverflow.fetch_add(1);
+                }
+                g_speechPending.push_back(std::move(item));
+            }
+        }
+
+        tail = (tail + 1) % SPEECH_QUEUE_SIZE;
+        g_speechQueueTail.store(tail, std::memory_order_release);
+    }
+
+    g_speechPendingDepth.store((int)g_speechPending.size());
+    return cancelSeen;
+}
+
+// Whether a command can be sent now. Normal/next speech waits while the queued SSML lane
+// speaks (NVDA would queue it behind that utterance anyway, and the order is kept); NOW
+// speech goes ahead: plain text cancels, SSML takes the NOW lane when it is idle.
+static bool speech_can_send(const SpeechCommand& item) {
+    if (!is_speech_command(item.type)) return true;
+    if (item.priority == SPEECH_PRIORITY_NOW) {
+        return item.type != SPEECH_CMD_SSML || !g_speechLanes[SPEECH_LANE_NOW].busy.load(std::memory_order_acquire);
+    }
+    return !g_speechLanes[SPEECH_LANE_QUEUED].busy.load(std::memory_order_acquire);
+}
+
+// Remove and return the next command to send: highest priority first, FIFO within a class,
+// skipping commands that must wait for a lane (speech_can_send). Stale speech found on the
+// way is dropped. Returns false if nothing can be sent.
+static bool speech_pop_next(SpeechCommand& next) {
+    long long now = now_us();
+
+    for (;;) {
+        size_t best = g_speechPending.size();
+        for (size_t i = 0; i < g_speechPending.size(); i++) {
+            if (!speech_can_send(g_speechPending[i])) continue;
+            if (best == g_speechPending.size() || g_speechPending[i].priority > g_speechPending[best].priority) best = i;
+        }
+        if (best == g_speechPending.size()) return false;
+
+        SpeechCommand& item = g_speechPending[best];
+        bool stale = (is_speech_command(item.type) && item.maxAgeUs > 0 && now - item.queuedAt > item.maxAgeUs);
+        if (!stale) {
+            next = std::move(item);
+        } else {
+            g_speechStale.fetch_add(1);
+        }
+        g_speechPending.erase(g_speechPending.begin() + best);
+        g_speechPendingDepth.store((int)g_speechPending.size());
+
+        if (!stale) return true;
+    }
+}
+
+// ============================================================================
+// SSML Mark Events (NVDA callback -> SQF)
+// ============================================================================
+
+// NVDA calls on_ssml_mark_reached on the lane thread whose speakSsml call is in flight
+// when speech reaches a <mark>. Marks are raised straight to SQF through the ExtensionCallback event when
+// Arma registered a callback, and otherwise buffered here until speech_poll drains them.
+struct SpeechMarkEvent {
+    char mark[64];          // UTF-8 mark name
+    long long reachedAt;    // now_us() when NVDA reported it
+};
+
+// Ring buffer of reached marks (producer: a lane thread, consumer: speech_poll)
+// NVDA reports marks one at a time from its speech thread, so only one lane produces at once
+static const int SPEECH_MARK_QUEUE_SIZE = 64;
+static SpeechMarkEvent g_speechMarkQueue[SPEECH_MARK_QUEUE_SIZE];
+static std::atomic<int> g_speechMarkHead(0);
+static std::atomic<int> g_speechMarkTail(0);
+
+static std::atomic<unsigned int> g_speechMarksReached(0);  // Marks reported by NVDA
+static std::atomic<unsigned int> g_speechMarksRaised(0);   // Marks sent via ExtensionCallback
+static std::atomic<unsigned int> g_speechMarksDropped(0);  // Marks lost (buffer full)
+
+error_status_t __stdcall on_ssml_mark_reached(const wchar_t* mark) {
+    // Hidden completion mark: the last utterance finished, stop ducking (hold still applies)
+    size_t prefixLength = wcslen(SPEECH_DONE_MARK_PREFIX);
+    if (mark && wcsncmp(mark, SPEECH_DONE_MARK_PREFIX, prefixLength) == 0) {
+        unsigned int seq = (unsigned int)wcstoul(mark + prefixLength, nullptr, 10);
+        if (seq != 0 && seq == g_speechDoneSeq.load()) {
+            g_speechBusyUntilUs.store(now_us(), std::memory_order_relaxed);
+        }
+        return 0;
+    }
+
+    g_speechMarksReached.fetch_add(1);
+
+    SpeechMarkEvent event;
+    wstring_to_utf8(mark, event.mark, sizeof(event.mark));
+    event.reachedAt = now_us();
+
+    // Preferred: push straight into Arma's callback queue (-1 = Arma's queue is full)
+    ArmaCallbackFunc callback = g_armaCallback.load();
+    if (callback && callback("nvda_arma3_bridge", "speech_mark", event.mark) >= 0) {
+        g_speechMarksRaised.fetch_add(1);
+        return 0;
+    }
+
+    int head = g_speechMarkHead.load(std::memory_order_acquire);  // The other lane may have pushed last
+    int nextHead = (head + 1) % SPEECH_MARK_QUEUE_SIZE;
+    if (nextHead == g_speechMarkTail.load(std::memory_order_acquire)) {
+        g_speechMarksDropped.fetch_add(1);
+        return 0;
+    }
+
+    g_speechMarkQueue[head] = event;
+    g_speechMarkHead.store(nextHead, std::memory_order_release);
+    return 0;
+}
+
+// Worker thread - schedules and sends one command at a time, re-checking the queue
+// between RPCs so newly queued high priority speech can jump ahead
+static void speech_worker() {
+    g_speechPending.reserve(SPEECH_PENDING_MAX);
+    nvda_supports_ssml();
+    nvdaController_setOnSsmlMarkReachedCallback(on_ssml_mark_reached);
+    SpeechCommand next;
+
+    while (!g_speechShutdown.load()) {
+        if (speech_drain_queue()) {
+            SpeechCommand cancel;
+            cancel.type = SPEECH_CMD_CANCEL;
+            speech_execute(cancel);
+        }
+
+        if (!speech_pop_next(next)) {
+            WaitForSingleObject(g_speechWakeEvent, INFINITE);
+            continue;
+        }
+
+        speech_execute(next);
+    }
+}
+
+// Lane thread - makes one synchronous speakSsml call per hand-over (marks arrive during it)
+static void speech_lane_run(SpeechLane& lane) {
+    while (!g_speechShutdown.load()) {
+        WaitForSingleObject(lane.wakeEvent, INFINITE);
+        if (!lane.busy.load(std::memory_order_acquire)) continue;  // Woken for shutdown
+
+        if (nvdaController_speakSsml(lane.ssml.c_str(), SYMBOL_LEVEL_UNCHANGED, lane.priority, FALSE) != 0) {
+            g_speechErrors.fetch_add(1);
+        }
+        lane.busy.store(false, std::memory_order_release);
+        SetEvent(g_speechWakeEvent);  // Speech held for this lane can go now
+    }
+}
+
+static void speech_lane_queued() { speech_lane_run(g_speechLanes[SPEECH_LANE_QUEUED]); }
+static void speech_lane_now() { speech_lane_run(g_speechLanes[SPEECH_LANE_NOW]); }
+
+// Speech threads in start order (the worker last, once its lanes are there)
+static void (*const SPEECH_THREADS[])() = { speech_lane_queued, speech_lane_now, speech_worker };
+static const int SPEECH_THREAD_COUNT = (int)(sizeof(SPEECH_THREADS) / sizeof(SPEECH_THREADS[0]));
+static int g_speechThreadsStarted = 0;
+
+// Start the speech worker and its SSML lanes (once; a failed start is retried next call)
+bool init_speech() {
+    if (g_speechInitialized) {
+        return true;
+    }
+
+    if (g_speechWakeEvent == NULL) {
+        g_speechWakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+        if (g_speechWakeEvent == NULL) return false;
+    }
+    for (SpeechLane& lane : g_speechLanes) {
+        if (lane.wakeEvent == NULL) {
+            lane.wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+            if (lane.wakeEvent == NULL) return false;
+        }
+    }
+
+    // Detached: DllMain must never wait on them during process exit
+    while (g_speechThreadsStarted < SPEECH_THREAD_COUNT) {
+        if (!start_worker_thread(SPEECH_THREADS[g_speechThreadsStarted])) return false;
+        g_speechThreadsStarted++;
+    }
+
+    g_speechInitialized = true;
+    return true;
+}
+
+// Stop the speech worker and lanes (pending commands are abandoned; a lane in a call
+// finishes it first)
+void shutdown_speech() {
+    if (g_speechInitialized) {
+        g_speechShutdown.store(true);
+        SetEvent(g_speechWakeEvent);
+        for (SpeechLane& lane : g_speechLanes) {
+            SetEvent(lane.wakeEvent);
+        }
+    }
+}
+
+// Queue an NVDA call for the worker thread
+// priority: SPEECH_PRIORITY_*, key: coalescing key ("" = none), maxAgeSec: drop after this long (0 = never)
+// rateBoost/pitchBoost/mark: SSML prosody and mark for SPEECH_CMD_SSML
+// Returns "QUEUED" on success, otherwise an error code
+const char* speech_enqueue(int type, const std::wstring& text,
+                           int priority = SPEECH_PRIORITY_NORMAL, const char* key = "", float maxAgeSec = 0.0f,
+                           int rateBoost = 0, int pitchBoost = 0, const std::wstring& mark = std::wstring()) {
+    if (!init_speech()) {
+        return "SPEECH_INIT_FAILED";
+    }
+
+    int head = g_speechQueueHead.load(std::memory_order_relaxed);
+    int nextHead = (head + 1) % SPEECH_QUEUE_SIZE;
+    if (nextHead == g_speechQueueTail.load(std::memory_order_acquire)) {
+        g_speechFull.fetch_add(1);
+        return "QUEUE_FULL";
+    }
+
+    SpeechCommand& slot = g_speechQueue[head];
+    slot.type = type;
+    slot.text = text;
+    slot.priority = priority;
+    slot.key = key ? key : "";
+    slot.queuedAt = now_us();
+    slot.maxAgeUs = (maxAgeSec > 0.0f) ? (long long)(maxAgeSec * 1000000.0f) : 0;
+    slot.rateBoost = rateBoost;
+    slot.pitchBoost = pitchBoost;
+    slot.mark = mark;
+
+    // Publish the new head (makes the command visible to the worker)
+    g_speechQueueHead.store(nextHead, std::memory_order_release);
+    g_speechQueued.fetch_add(1);
+
+    SetEvent(g_speechWakeEvent);
+    return "QUEUED";
+}
+
+// Format queue depth, counters and RPC latency percentiles as compact JSON
+void speech_stats(char* output, int outputSize) {
+    int head = g_speechQueueHead.load(std::memory_order_acquire);
+    int tail = g_speechQueueTail.load(std::memory_order_acquire);
+    int depth = (head - tail + SPEECH_QUEUE_SIZE) % SPEECH_QUEUE_SIZE;
+
+    unsigned int total = g_speechLatencyCount.load();
+    int samples = (total < (unsigned int)SPEECH_LATENCY_HISTORY) ? (int)total : SPEECH_LATENCY_HISTORY;
+    unsigned int sorted[SPEECH_LATENCY_HISTORY];
+    for (int i = 0; i < samples; i++) {
+        sorted[i] = g_speechLatencyUs[i].load(std::memory_order_relaxed);
+    }
+    std::sort(sorted, sorted + samples);
+
+    auto percentileMs = [&](int pct) -> double {
+        if (samples == 0) return 0.0;
+        int idx = (samples * pct + 99) / 100 - 1;
+        idx = (idx < 0) ? 0 : (idx >= samples) ? samples - 1 : idx;
+        return sorted[idx] / 1000.0;
+    };
+
+    char buf[768];
+    snprintf(buf, sizeof(buf),
+        "{\"depth\":%d,\"pending\":%d,\"capacity\":%d,\"queued\":%u,\"spoken\":%u,\"ssml\":%u,"
+        "\"ssml_fallback\":%u,\"ssml_support\":%d,\"braille\":%u,"
+        "\"cancels\":%u,\"interrupts\":%u,\"skipped\":%u,\"coalesced\":%u,\"stale\":%u,\"overflow\":%u,"
+        "\"full\":%u,\"errors\":%u,\"marks\":%u,\"marks_raised\":%u,\"marks_dropped\":%u,"
+        "\"rpc_ms\":{\"samples\":%d,\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"max\":%.3f}}",
+        depth, g_speechPendingDepth.load(), SPEECH_QUEUE_SIZE - 1,
+        g_speechQueued.load(), g_speechSpoken.load(), g_speechSsml.load(),
+        g_speechSsmlFallback.load(), g_nvdaSsmlSupport.load(), g_speechBrailled.load(),
+        g_speechCancels.load(), g_speechInterrupts.load(), g_speechSkipped.load(), g_speechCoalesced.load(),
+        g_speechStale.load(), g_speechOverflow.load(), g_speechFull.load(), g_speechErrors.load(),
+        g_speechMarksReached.load(), g_speechMarksRaised.load(), g_speechMarksDropped.load(),
+        samples, percentileMs(50), percentileMs(95), percentileMs(99), percentileMs(100));
+    safe_output(output, outputSize, buf);
+}
+
+// Drain buffered SSML marks as an SQF array: [["mark", ageSeconds], ...]
+// Stops early (leaving the rest buffered) if the output buffer would overflow
+void speech_poll(char* output, int outputSize) {
+    std::string result = "[";
+    long long now = now_us();
+
+    int tail = g_speechMarkTail.load(std::memory_order_relaxed);
+    while (tail != g_speechMarkHead.load(std::memory_order_acquire)) {
+        const SpeechMarkEvent& event = g_speechMarkQueue[tail];
+
+        // SQF string literal: double any embedded quotes
+        std::string entry = "[\"";
+        for (const char* c = event.mark; *c; c++) {
+            entry += *c;
+            if (*c == '"') entry += '"';
+        }
+        char age[32];
+        snprintf(age, sizeof(age), "\",%.3f]", (now - event.reachedAt) / 1000000.0);
+        entry += age;
+
+        if ((int)(result.size() + entry.size() + 2) > outputSize) break;
+        if (result.size() > 1) result += ",";
+        result += entry;
+
+        tail = (tail + 1) % SPEECH_MARK_QUEUE_SIZE;
+        g_speechMarkTail.store(tail, std::memory_order_release);
+    }
+
+    result += "]";
+    safe_output(output, outputSize, result.c_str());
+}
+
+// ============================================================================
+// Command Handlers
+// ============================================================================
+
+// Handler signature: args is the text after "name:" (empty for bare commands)
+typedef void (*CommandHandler)(char* output, int outputSize, std::string_view args);
+
+// Command: test - Check if NVDA is running
+static void cmd_test(char* output, int outputSize, std::string_view args) {
+    error_status_t result = nvdaController_testIfRunning();
+    if (result == 0) {
+        safe_output(output, outputSize, "OK");
+    } else {
+        safe_output(output, outputSize, "NVDA_NOT_RUNNING");
+    }
+}
+
+// Command: speak:text - Queue text for NVDA to speak
+static void cmd_speak(char* output, int outputSize, std::string_view args) {
+    if (!args.empty()) {
+        safe_output(output, outputSize, speech_enqueue(SPEECH_CMD_SPEAK, utf8_to_wstring(args)));
+    } else {
+        safe_output(output, outputSize, "EMPTY_TEXT");
+    }
+}
+
+// Command: cancel - Stop current speech (also drops speech still waiting in the queue)
+static void cmd_cancel(char* output, int outputSize, std::string_view args) {
+    safe_output(output, outputSize, speech_enqueue(SPEECH_CMD_CANCEL, std::wstring()));
+}
+
+// Command: braille:text - Queue message for the braille display
+static void cmd_braille(char* output, int outputSize, std::string_view args) {
+    if (!args.empty()) {
+        safe_output(output, outputSize, speech_enqueue(SPEECH_CMD_BRAILLE, utf8_to_wstring(args)));
+    } else {
+        safe_output(output, outputSize, "EMPTY_TEXT");
+    }
+}
+
+// Command: speech_stats - Report speech queue depth, counters and RPC latency percentiles
+static void cmd_speech_stats(char* output, int outputSize, std::string_view args) {
+    speech_stats(output, outputSize);
+}
+
+// Command: speech_poll - Drain SSML marks reached since the last poll
+// Returns [["mark", ageSeconds], ...]. Only needed when the ExtensionCallback
+// event is unavailable; otherwise marks arrive as ("nvda_arma3_bridge", "speech_mark", mark).
+static void cmd_speech_poll(char* output, int outputSize, std::string_view args) {
+    speech_poll(output, outputSize);
+}
+
+// ----------------------------------------------------------------------------
+// Aim Assist Audio Commands
+// ----------------------------------------------------------------------------
+
+// Command: aim_start - Initialize audio and start (silent) tone
+static void cmd_aim_start(char* output, int outputSize, std::string_view args) {
+    if (init_audio()) {
+        AimParams aim = g_aimParams.get();
+        aim.pan = 0.0f;
+        aim.pitch = 550.0f;
+        aim.vertError = 1.0f;         // Start at max error
+        aim.horizError = 1.0f;        // Start at max error
+        aim.muted = true;             // Start muted until we have a target
+        aim.active = true;
+        aim.resetCount++;             // Audio thread resets the chirp (begin_buffer)
+        g_aimParams.publish(aim);
+        safe_output(output, outputSize, "OK");
+    } else {
+        safe_output(output, outputSize, "AUDIO_INIT_FAILED");
+    }
+}
+
+// Command: aim_update:pan,pitch,vertError,horizError,vertThreshold,horizThreshold[,panVel,vertErrVel]
+// pan: -1.0 to 1.0 (left to right)
+// pitch: frequency in Hz (typically 300-800, 550 = vertically centered)
+// vertError: 0.0 to 1.0 (0 = dead center vertically)
+// horizError: 0.0 to 1.0 (0 = dead center horizontally)
+// vertThreshold: adaptive threshold based on target angular size
+// horizThreshold: adaptive threshold based on target angular size
+// panVel/vertErrVel: optional rates of change per second; the audio thread extrapolates
+//   pan and vertError along them until the next update (up to AIM_EXTRAPOLATE_MAX_MS)
+// The measurement is timed by its arrival: SQF flushes the frame packet in the frame it
+// measured (BA_audioFrameFlush), and diag_tickTime would not survive SQF's 6-digit formatting
+// Special: pitch of -1 means mute (no target)
+// Missing trailing fields keep their defaults.
+static void apply_aim_update(float pan, float pitch, float vertError, float horizError,
+                             float vertThreshold, float horizThreshold,
+                             float panVelocity = 0.0f, float vertErrorVelocity = 0.0f) {
+    AimParams aim = g_aimParams.get();
+    aim.sampleTimeUs = now_us();
+    aim.panVelocity = 0.0f;
+    aim.vertErrorVelocity = 0.0f;
+
+    // Check for mute signal (pitch == -1)
+    if (pitch < 0) {
+        aim.muted = true;
+    } else {
+        aim.muted = false;
+
+        // Clamp values to valid ranges
+        pan = (pan < -1.0f) ? -1.0f : (pan > 1.0f) ? 1.0f : pan;
+        pitch = (pitch < 100.0f) ? 100.0f : (pitch > 2000.0f) ? 2000.0f : pitch;
+        vertError = (vertError < 0.0f) ? 0.0f : (vertError > 1.0f) ? 1.0f : vertError;
+        horizError = (horizError < 0.0f) ? 0.0f : (horizError > 1.0f) ? 1.0f : horizError;
+        vertThreshold = (vertThreshold < 0.001f) ? 0.001f : (vertThreshold > 0.5f) ? 0.5f : vertThreshold;
+        horizThreshold = (horizThreshold < 0.001f) ? 0.001f : (horizThreshold > 0.5f) ? 0.5f : horizThreshold;
+
+        aim.pan = pan;
+        aim.pitch = pitch;
+        aim.vertError = vertError;
+        aim.horizError = horizError;
+        aim.vertThreshold = vertThreshold;
+        aim.horizThreshold = horizThreshold;
+        aim.panVelocity = (panVelocity < -10.0f) ? -10.0f : (panVelocity > 10.0f) ? 10.0f : panVelocity;
+        aim.vertErrorVelocity = (vertErrorVelocity < -10.0f) ? -10.0f : (vertErrorVelocity > 10.0f) ? 10.0f : vertErrorVelocity;
+    }
+
+    // Publish all values together (the callback never sees a half-applied update)
+    aim.publishedNs = now_ns();
+    g_aimParams.publish(aim);
+}
+
+static void cmd_aim_update(char* output, int outputSize, std::string_view args) {
+    float pan = parse_float(next_field(args), 0.0f);
+    float pitch = parse_float(next_field(args), 550.0f);
+    float vertError = parse_float(next_field(args), 1.0f);
+    float horizError = parse_float(next_field(args), 1.0f);
+    float vertThreshold = parse_float(next_field(args), 0.02f);    // Default fallback
+    float horizThreshold = parse_float(next_field(args), 0.005f);  // Default fallback
+    float panVelocity = parse_float(next_field(args), 0.0f);
+    float vertErrorVelocity = parse_float(next_field(args), 0.0f);
+
+    apply_aim_update(pan, pitch, vertError, horizError, vertThreshold, horizThreshold,
+                     panVelocity, vertErrorVelocity);
+    safe_output(output, outputSize, "OK");
+}
+
+// Command: aim_blip - Play a one-shot vertical lock blip (800 Hz)
+static void cmd_aim_blip(char* output, int outputSize, std::string_view args) {
+    g_aimBlipPending.store(true);
+    safe_output(output, outputSize, "OK");
+}
+
+// Command: aim_unlock_blip - Play a one-shot vertical unlock blip (500 Hz)
+static void cmd_aim_unlock_blip(char* output, int outputSize, std::string_view args) {
+    g_aimUnlockBlipPending.store(true);
+    safe_output(output, outputSize, "OK");
+}
+
+// Command: aim_horiz_on - Enable horizontal guidance tone
+static void cmd_aim_horiz_on(char* output, int outputSize, std::string_view args) {
+    AimParams aim = g_aimParams.get();
+    aim.horizEnabled = true;
+    g_aimParams.publish(aim);
+    safe_output(output, outputSize, "OK");
+}
 
-            // Final sample with volume and envelope
-            float beaconSample = g_beaconLpfState * BEACON_VOLUME * g_beaconEnvelopeState;
+// Command: aim_horiz_off - Disable horizontal guidance tone
+static void cmd_aim_horiz_off(char* output, int outputSize, std::string_view args) {
+    AimParams aim = g_aimParams.get();
+    aim.horizEnabled = false;
+    g_aimParams.publish(aim);
+    safe_output(output, outputSize, "OK");
+}
 
-            // Apply stereo panning - widen by 2x for more dramatic separation
-            float widePan = beaconPan * 2.0f;
-            if (widePan > 1.0f) widePan = 1.0f;
-            if (widePan < -1.0f) widePan = -1.0f;
-            float beaconLeftGain = (widePan <= 0.0f) ? 1.0f : (1.0f - widePan);
-            float beaconRightGain = (widePan >= 0.0f) ? 1.0f : (1.0f + widePan);
+// Command: aim_stop - Stop the tone and disable aim assist
+static void cmd_aim_stop(char* output, int outputSize, std::string_view args) {
+    AimParams aim = g_aimParams.get();
+    aim.active = false;
+    aim.muted = true;
+    aim.horizEnabled = false;
+    g_aimParams.publish(aim);
+    safe_output(output, outputSize, "OK");
+}
 
-            leftSample += beaconSample * beaconLeftGain;
-            rightSample += beaconSample * beaconRightGain;
-        }
+// ----------------------------------------------------------------------------
+// Terrain Radar Audio Commands
+// ----------------------------------------------------------------------------
+
+// Command: radar_start - Initialize audio for terrain radar
+static void cmd_radar_start(char* output, int outputSize, std::string_view args) {
+    if (init_audio()) {
+        // Queue and voices are reset by the audio callback (apply_radar_reset)
+        g_radarResetGeneration.fetch_add(1, std::memory_order_release);
+        g_radarSweepActive.store(false);
+        g_radarActive.store(true);
+        safe_output(output, outputSize, "OK");
+    } else {
+        safe_output(output, outputSize, "AUDIO_INIT_FAILED");
+    }
+}
+
+// Command: radar_beep:pan,distance,material
+// pan: -1.0 to 1.0 (left to right stereo position)
+// distance: meters to target (used for volume calculation)
+// material: grass, concrete, wood, metal, water, man, glass, default, none, or a raw
+// surface with an optional "|kind" (see Radar Material Classification)
+// Beep for a radar sample; false for material "none" (no beep)
+static bool make_radar_beep(float pan, float distance, std::string_view material, RadarBeep& beep) {
+    // Clamp pan
+    pan = (pan < -1.0f) ? -1.0f : (pan > 1.0f) ? 1.0f : pan;
+
+    // Calculate volume using logarithmic distance falloff
+    // Volume is loud at 0.5m, very quiet at 100m
+    float loudDist = 0.5f;
+    float quietDist = 100.0f;
+    float clampedDist = (distance < loudDist) ? loudDist : (distance > quietDist) ? quietDist : distance;
+    float logRange = logf(quietDist) - logf(loudDist);  // ~5.3
+    float volume = 1.0f - (logf(clampedDist) - logf(loudDist)) / logRange;
+    volume = (volume < 0.02f) ? 0.02f : volume;  // Floor at 2% for audibility
+
+    int matCode = classify_material(material);
+
+    beep.pan = pan;
+    beep.volume = volume;
+    beep.material = matCode;
+    beep.azimuth = pan * BINAURAL_PAN_AZIMUTH;
+    beep.elevation = 0.0f;
+    beep.queuedNs = 0;
+    return matCode != MATERIAL_NONE;
+}
 
-        // Output stereo
-        *output++ = leftSample;
-        *output++ = rightSample;
+// Overflow with the coalesce policy: the beep replaces whatever waits in its pan bucket
+static void coalesce_radar_beep(const RadarBeep& beep) {
+    int bucket = (int)((beep.pan + 1.0f) * 0.5f * RADAR_PAN_BUCKETS);
+    bucket = (bucket < 0) ? 0 : (bucket >= RADAR_PAN_BUCKETS) ? RADAR_PAN_BUCKETS - 1 : bucket;
 
-        // Advance phases (primary phase is advanced inside the chirp section above)
+    RadarBucketBeep slot = g_radarBuckets[bucket].get();
+    if (g_radarBucketPlayedSeq[bucket].load(std::memory_order_acquire) != slot.seq) {
+        g_radarCoalesced.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot.beep = beep;
+    slot.seq++;
+    g_radarBuckets[bucket].publish(slot);
+}
 
-        if (primaryPulseRate > 0.0f) {
-            g_pulsePhase += primaryPulseInc;
-            if (g_pulsePhase >= 2.0 * PI) g_pulsePhase -= 2.0 * PI;
-        } else {
-            g_pulsePhase = 0.0;  // Reset when continuous
+// Queue a beep for the audio callback; returns the reply: "OK", "FULL" (queued, but an
+// older beep was dropped or merged to make room) or "DROPPED" (this beep was discarded)
+static const char* push_radar_beep(const RadarBeep& beep) {
+    const char* reply = "OK";
+    int head = g_radarQueueHead.load(std::memory_order_relaxed);
+    int nextHead = (head + 1) % RADAR_QUEUE_SIZE;
+    int tail = g_radarQueueTail.load(std::memory_order_acquire);
+
+    if (nextHead == tail) {
+        g_radarOverflows.fetch_add(1, std::memory_order_relaxed);
+        switch (g_radarOverflowPolicy.load(std::memory_order_relaxed)) {
+            case RADAR_OVERFLOW_DROP_NEWEST:
+                g_radarDroppedNewest.fetch_add(1, std::memory_order_relaxed);
+                return "DROPPED";
+            case RADAR_OVERFLOW_COALESCE:
+                coalesce_radar_beep(beep);
+                return "FULL";
+            default:
+                // Drop the oldest beep; if the callback took it first there is room anyway
+                if (g_radarQueueTail.compare_exchange_strong(tail, (tail + 1) % RADAR_QUEUE_SIZE, std::memory_order_acq_rel)) {
+                    g_radarDroppedOldest.fetch_add(1, std::memory_order_relaxed);
+                }
+                reply = "FULL";
+                break;
         }
+    }
 
-        g_clickPhase += clickPhaseInc;
-        if (g_clickPhase >= 2.0 * PI) g_clickPhase -= 2.0 * PI;
+    // Store beep parameters in queue, then publish the new head (makes beep visible to audio callback)
+    g_radarQueue[head] = beep;
+    g_radarQueueHead.store(nextHead, std::memory_order_release);
+    g_radarQueued.fetch_add(1, std::memory_order_relaxed);
 
-        if (secondaryPulseRate > 0.0f) {
-            g_clickPulsePhase += clickPulseInc;
-            if (g_clickPulsePhase >= 2.0 * PI) g_clickPulsePhase -= 2.0 * PI;
-        } else {
-            g_clickPulsePhase = 0.0;  // Reset when continuous
-        }
+    int depth = (nextHead - g_radarQueueTail.load(std::memory_order_relaxed) + RADAR_QUEUE_SIZE) % RADAR_QUEUE_SIZE;
+    if (depth > g_radarQueuePeak.load(std::memory_order_relaxed)) {
+        g_radarQueuePeak.store(depth, std::memory_order_relaxed);
     }
+    return reply;
 }
 
-// Initialize audio device
-bool init_audio() {
-    if (g_audioInitialized) {
-        return true;
+// direction (optional): [azimuth, elevation] in degrees for binaural rendering
+static const char* queue_radar_beep(float pan, float distance, std::string_view material,
+                                    const float* direction = nullptr) {
+    RadarBeep beep;
+
+    // Only queue beep if not "none" and radar is active
+    if (make_radar_beep(pan, distance, material, beep) && g_radarActive.load()) {
+        if (direction) {
+            beep.azimuth = direction[0];
+            beep.elevation = direction[1];
+        }
+        beep.queuedNs = now_ns();
+        return push_radar_beep(beep);
     }
+    return "OK";
+}
 
-    ma_device_config config = ma_device_config_init(ma_device_type_playback);
-    config.playback.format = ma_format_f32;
-    config.playback.channels = 2;  // Stereo for panning
-    config.sampleRate = SAMPLE_RATE;
-    config.dataCallback = audio_callback;
-    config.pUserData = nullptr;
+static void cmd_radar_beep(char* output, int outputSize, std::string_view args) {
+    float pan = parse_float(next_field(args), 0.0f);
+    float distance = parse_float(next_field(args), 50.0f);
+    std::string_view material = args.empty() ? std::string_view("default") : args;
 
-    if (ma_device_init(nullptr, &config, &g_audioDevice) != MA_SUCCESS) {
-        return false;
+    safe_output(output, outputSize, queue_radar_beep(pan, distance, material));
+}
+
+// Command: radar_stop - Stop terrain radar audio
+static void cmd_radar_stop(char* output, int outputSize, std::string_view args) {
+    g_radarActive.store(false);
+    g_radarSweepActive.store(false);
+    // Queue and voices are cleared by the audio callback (apply_radar_reset)
+    g_radarResetGeneration.fetch_add(1, std::memory_order_release);
+    safe_output(output, outputSize, "OK");
+}
+
+// Command: radar_sweep_start:sweepMs,sampleCount - Let the audio clock drive the sweep:
+// sample index i plays at i * sweepMs / sampleCount into each sweep, using the hit last
+// uploaded for it with radar_sweep_hit. All hits start silent; samples count from 0.
+static void cmd_radar_sweep_start(char* output, int outputSize, std::string_view args) {
+    float sweepMs = parse_float(next_field(args), 1000.0f);
+    int sampleCount = parse_int(args, 45);
+    if (sweepMs < 50.0f || sweepMs > 60000.0f || sampleCount < 1 || sampleCount > RADAR_SWEEP_MAX_SAMPLES) {
+        safe_output(output, outputSize, "BAD_ARGS");
+        return;
     }
 
-    if (ma_device_start(&g_audioDevice) != MA_SUCCESS) {
-        ma_device_uninit(&g_audioDevice);
-        return false;
+    g_radarSweepActive.store(false);
+    for (int i = 0; i < sampleCount; i++) {
+        g_radarSweepHits[i].publish(RadarSweepHit());
     }
+    g_radarSweepPeriodFrames.store((int)(sweepMs * g_sampleRate / 1000.0f), std::memory_order_relaxed);
+    g_radarSweepSampleCount.store(sampleCount, std::memory_order_relaxed);
+    g_radarSweepPosition.store(0, std::memory_order_relaxed);
+    g_radarSweepGeneration.fetch_add(1, std::memory_order_release);
+    g_radarSweepActive.store(true);
+    safe_output(output, outputSize, "OK");
+}
 
-    g_audioInitialized = true;
+// Command: radar_sweep_hit:sample,pan,distance,material - Hit for one sweep sample, counted
+// across sweeps like radar_sweep_pos (index = sample mod sampleCount, sweep = sample /
+// sampleCount, wrapping every RADAR_SWEEP_WRAP_SWEEPS sweeps). The wrapped sweep is taken
+// as the one nearest the clock's. Same pan/distance/material as radar_beep; "none"
+// silences the index.
+static bool apply_radar_sweep_hit(int sample, float pan, float distance, std::string_view material,
+                                  const float* direction = nullptr) {
+    int sampleCount = g_radarSweepSampleCount.load(std::memory_order_relaxed);
+    if (sample < 0 || sampleCount <= 0) {
+        return false;
+    }
+    int index = sample % sampleCount;
+    int wrappedSweep = (sample / sampleCount) % RADAR_SWEEP_WRAP_SWEEPS;
+
+    // Unwrap against the clock: within half the wrap either side of its current sweep
+    long long position = std::max(0LL, g_radarSweepPosition.load(std::memory_order_relaxed));
+    unsigned int clockSweep = (unsigned int)(position / sampleCount);
+    int delta = (wrappedSweep - (int)(clockSweep % RADAR_SWEEP_WRAP_SWEEPS) + RADAR_SWEEP_WRAP_SWEEPS) % RADAR_SWEEP_WRAP_SWEEPS;
+    if (delta >= RADAR_SWEEP_WRAP_SWEEPS / 2) delta -= RADAR_SWEEP_WRAP_SWEEPS;
+
+    RadarSweepHit hit;
+    hit.audible = make_radar_beep(pan, distance, material, hit.beep);
+    hit.sweep = clockSweep + (unsigned int)delta;
+    if (direction) {
+        hit.beep.azimuth = direction[0];
+        hit.beep.elevation = direction[1];
+    }
+    g_radarSweepHits[index].publish(hit);
     return true;
 }
 
-// Shutdown audio device
-void shutdown_audio() {
-    if (g_audioInitialized) {
-        g_shuttingDown.store(true);
-        g_aimActive.store(false);
-        g_aimMuted.store(true);
+static void cmd_radar_sweep_hit(char* output, int outputSize, std::string_view args) {
+    int sample = parse_int(next_field(args), -1);
+    float pan = parse_float(next_field(args), 0.0f);
+    float distance = parse_float(next_field(args), 50.0f);
+    std::string_view material = args.empty() ? std::string_view("default") : args;
 
-        // Just stop the device, don't uninitialize
-        // Let the OS clean up on process exit to avoid deadlock
-        ma_device_stop(&g_audioDevice);
+    safe_output(output, outputSize, apply_radar_sweep_hit(sample, pan, distance, material) ? "OK" : "BAD_ARGS");
+}
 
-        // DON'T call ma_device_uninit() - it can deadlock during shutdown
-        // g_audioInitialized stays true but that's fine, process is exiting
+// Command: radar_sweep_pos - Next sample the audio clock plays, counted across sweeps and
+// wrapped to 0 every RADAR_SWEEP_WRAP_SWEEPS sweeps (-1 while no sweep runs). SQF uploads
+// hits from here up to its lookahead, so both sides follow the one clock.
+static void cmd_radar_sweep_pos(char* output, int outputSize, std::string_view args) {
+    long long sample = -1;
+    if (g_radarSweepActive.load()) {
+        long long wrap = (long long)RADAR_SWEEP_WRAP_SWEEPS * g_radarSweepSampleCount.load(std::memory_order_relaxed);
+        sample = g_radarSweepPosition.load(std::memory_order_relaxed) % wrap;
     }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%lld", sample);
+    safe_output(output, outputSize, buf);
 }
 
-// ============================================================================
-// String Utilities
-// ============================================================================
+// Command: radar_sweep_stop - Stop scheduling sweep beeps (playing beeps finish)
+static void cmd_radar_sweep_stop(char* output, int outputSize, std::string_view args) {
+    g_radarSweepActive.store(false);
+    safe_output(output, outputSize, "OK");
+}
 
-// Convert UTF-8 string to wide string (UTF-16)
-std::wstring utf8_to_wstring(const std::string& str) {
-    if (str.empty()) return std::wstring();
+// Command: radar_steal:oldest|quietest - Which voice a beep takes when all are playing
+static void cmd_radar_steal(char* output, int outputSize, std::string_view args) {
+    if (args == "oldest") {
+        g_radarStealPolicy.store(RADAR_STEAL_OLDEST);
+    } else if (args == "quietest") {
+        g_radarStealPolicy.store(RADAR_STEAL_QUIETEST);
+    } else {
+        safe_output(output, outputSize, "BAD_ARGS");
+        return;
+    }
+    safe_output(output, outputSize, "OK");
+}
 
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.length(), NULL, 0);
-    if (size_needed <= 0) return std::wstring();
+// Command: radar_overflow:drop_oldest|drop_newest|coalesce - radar_beep policy when the queue is full
+static void cmd_radar_overflow(char* output, int outputSize, std::string_view args) {
+    if (args == "drop_oldest") {
+        g_radarOverflowPolicy.store(RADAR_OVERFLOW_DROP_OLDEST);
+    } else if (args == "drop_newest") {
+        g_radarOverflowPolicy.store(RADAR_OVERFLOW_DROP_NEWEST);
+    } else if (args == "coalesce") {
+        g_radarOverflowPolicy.store(RADAR_OVERFLOW_COALESCE);
+    } else {
+        safe_output(output, outputSize, "BAD_ARGS");
+        return;
+    }
+    safe_output(output, outputSize, "OK");
+}
 
-    std::wstring result(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.length(), &result[0], size_needed);
-    return result;
+// Command: radar_stats - Radar voice pool and beep queue counters (JSON)
+// surface_cache: [hits, misses] of the material classification LRU (unknown surfaces)
+static void cmd_radar_stats(char* output, int outputSize, std::string_view args) {
+    static const char* const OVERFLOW_NAMES[] = { "drop_oldest", "drop_newest", "coalesce" };
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+        "{\"voices\":%d,\"active\":%d,\"peak\":%d,\"beeps\":%u,\"stolen\":%u,\"steal\":\"%s\","
+        "\"queued\":%u,\"queue_peak\":%d,\"overflows\":%u,\"dropped_oldest\":%u,\"dropped_newest\":%u,"
+        "\"coalesced\":%u,\"overflow\":\"%s\",\"surface_cache\":[%u,%u]}",
+        RADAR_VOICE_COUNT,
+        g_radarVoicesActive.load(std::memory_order_relaxed),
+        g_radarVoicesPeak.load(std::memory_order_relaxed),
+        g_radarBeepsStarted.load(std::memory_order_relaxed),
+        g_radarVoicesStolen.load(std::memory_order_relaxed),
+        (g_radarStealPolicy.load() == RADAR_STEAL_QUIETEST) ? "quietest" : "oldest",
+        g_radarQueued.load(std::memory_order_relaxed),
+        g_radarQueuePeak.load(std::memory_order_relaxed),
+        g_radarOverflows.load(std::memory_order_relaxed),
+        g_radarDroppedOldest.load(std::memory_order_relaxed),
+        g_radarDroppedNewest.load(std::memory_order_relaxed),
+        g_radarCoalesced.load(std::memory_order_relaxed),
+        OVERFLOW_NAMES[g_radarOverflowPolicy.load()],
+        g_surfaceCacheHits, g_surfaceCacheMisses);
+    safe_output(output, outputSize, buf);
 }
 
-// Safe string copy to output buffer
-void safe_output(char* output, int outputSize, const char* str) {
-    if (output && outputSize > 0 && str) {
-        strncpy_s(output, outputSize, str, _TRUNCATE);
+// Command: material:surface[|kind] - Radar material a raw surface resolves to, as used by
+// radar_beep and radar_sweep_hit (debug logging, bench_materials)
+static void cmd_material(char* output, int outputSize, std::string_view args) {
+    int code = classify_material(args);
+    safe_output(output, outputSize, (code == MATERIAL_NONE) ? "none" : MATERIAL_NAMES[code]);
+}
+
+// ----------------------------------------------------------------------------
+// Navigation Beacon Audio Commands
+// ----------------------------------------------------------------------------
+
+// Command: beacon_start - Initialize audio and start beacon
+static void cmd_beacon_start(char* output, int outputSize, std::string_view args) {
+    if (init_audio()) {
+        BeaconParams beacon;
+        beacon.pan = 0.0f;
+        beacon.active = true;
+        beacon.resetCount = g_beaconParams.get().resetCount + 1;  // Audio thread resets the voice
+        g_beaconParams.publish(beacon);
+        safe_output(output, outputSize, "OK");
+    } else {
+        safe_output(output, outputSize, "AUDIO_INIT_FAILED");
     }
 }
 
-// Parse float from string
-float parse_float(const char* str, float defaultVal) {
-    if (!str || !*str) return defaultVal;
-    char* endptr;
-    float val = strtof(str, &endptr);
-    return (endptr != str) ? val : defaultVal;
+// Command: beacon_update:pan[,azimuth,elevation] - Update beacon pan value
+// pan: -1.0 (left) to +1.0 (right)
+// azimuth/elevation (optional, degrees): full direction for binaural rendering, so a
+// target behind sounds behind (pan alone folds it to the front)
+static void apply_beacon_update(float pan, const float* direction = nullptr) {
+    // Clamp pan to valid range
+    pan = (pan < -1.0f) ? -1.0f : (pan > 1.0f) ? 1.0f : pan;
+
+    BeaconParams beacon = g_beaconParams.get();
+    beacon.pan = pan;
+    beacon.hasDirection = direction != nullptr;
+    if (direction) {
+        beacon.azimuth = direction[0];
+        beacon.elevation = direction[1];
+    }
+    beacon.publishedNs = now_ns();
+    g_beaconParams.publish(beacon);
 }
 
-// Parse int from string
-int parse_int(const char* str, int defaultVal) {
-    if (!str || !*str) return defaultVal;
-    char* endptr;
-    long val = strtol(str, &endptr, 10);
-    return (endptr != str) ? (int)val : defaultVal;
+static void cmd_beacon_update(char* output, int outputSize, std::string_view args) {
+    float pan = parse_float(next_field(args), 0.0f);
+    if (args.empty()) {
+        apply_beacon_update(pan);
+    } else {
+        float direction[2];
+        direction[0] = parse_float(next_field(args), 0.0f);
+        direction[1] = parse_float(args, 0.0f);
+        apply_beacon_update(pan, direction);
+    }
+    safe_output(output, outputSize, "OK");
 }
 
-// ============================================================================
-// Arma 3 Extension Entry Points
-// ============================================================================
+// Command: beacon_stop - Stop navigation beacon
+static void cmd_beacon_stop(char* output, int outputSize, std::string_view args) {
+    BeaconParams beacon = g_beaconParams.get();
+    beacon.active = false;
+    beacon.resetCount++;
+    g_beaconParams.publish(beacon);
+    safe_output(output, outputSize, "OK");
+}
 
-// Return the extension version
-void __stdcall RVExtensionVersion(char *output, int outputSize) {
-    safe_output(output, outputSize, VERSION);
+// ----------------------------------------------------------------------------
+// Audio Settings Commands
+// ----------------------------------------------------------------------------
+
+// Render cost and deadline counters, as read by audio_stats and the CSV dump
+struct AudioStatsSnapshot {
+    unsigned int buffers;
+    unsigned long long frames;
+    double avgUsPer512;          // Mean render time normalized to a 512-frame buffer
+    double maxUs;
+    double loadPct;              // Render time as a percentage of the audio it produced
+    unsigned int hist[RENDER_HIST_BUCKETS];
+    unsigned int overruns;
+    unsigned int lateCallbacks;
+    unsigned int maxFrames;
+};
+
+static AudioStatsSnapshot read_audio_stats() {
+    AudioStatsSnapshot stats;
+    stats.buffers = g_audioBuffers.load(std::memory_order_relaxed);
+    stats.frames = g_audioFrames.load(std::memory_order_relaxed);
+    unsigned long long renderNs = g_audioRenderNs.load(std::memory_order_relaxed);
+    stats.avgUsPer512 = stats.frames ? (double)renderNs / 1000.0 * 512.0 / (double)stats.frames : 0.0;
+    stats.maxUs = g_audioRenderMaxNs.load(std::memory_order_relaxed) / 1000.0;
+    stats.loadPct = stats.frames ? (double)renderNs / 1e9 / ((double)stats.frames / g_sampleRate) * 100.0 : 0.0;
+    for (int b = 0; b < RENDER_HIST_BUCKETS; b++) {
+        stats.hist[b] = g_audioRenderHist[b].load(std::memory_order_relaxed);
+    }
+    stats.overruns = g_audioOverruns.load(std::memory_order_relaxed);
+    stats.lateCallbacks = g_audioLateCallbacks.load(std::memory_order_relaxed);
+    stats.maxFrames = g_audioMaxFrames.load(std::memory_order_relaxed);
+    return stats;
 }
 
-// Main extension entry point (single argument as string)
-void __stdcall RVExtension(char *output, int outputSize, const char *function) {
-    if (!function || !output || outputSize <= 0) {
+// Command: audio_config - Device settings and the open device (JSON)
+// audio_config:key,value - Change one setting (backend, period_frames, periods, sample_rate,
+// mode); an open device is reopened with it. audio_config:save - Write the settings to
+// nvda_arma3_bridge_audio.ini next to the DLL, read on the first device open.
+static void cmd_audio_config(char* output, int outputSize, std::string_view args) {
+    load_audio_config();
+    if (args == "save") {
+        safe_output(output, outputSize, save_audio_config() ? "OK" : "SAVE_FAILED");
         return;
     }
-
-    std::string cmd(function);
-
-    // Command: test - Check if NVDA is running
-    if (cmd == "test") {
-        error_status_t result = nvdaController_testIfRunning();
-        if (result == 0) {
-            safe_output(output, outputSize, "OK");
-        } else {
-            safe_output(output, outputSize, "NVDA_NOT_RUNNING");
+    if (!args.empty()) {
+        std::string_view key = next_field(args);
+        if (!set_audio_config_value(g_audioConfig, key, args)) {
+            safe_output(output, outputSize, "BAD_ARGS");
+            return;
         }
+        safe_output(output, outputSize, reopen_audio() ? "OK" : "AUDIO_INIT_FAILED");
         return;
     }
 
-    // Command: speak:text - Make NVDA speak text
-    if (cmd.rfind("speak:", 0) == 0) {
-        std::string text = cmd.substr(6);
-        if (!text.empty()) {
-            std::wstring wtext = utf8_to_wstring(text);
-            error_status_t result = nvdaController_speakText(wtext.c_str());
-            if (result == 0) {
-                safe_output(output, outputSize, "OK");
-            } else {
-                safe_output(output, outputSize, "NVDA_ERROR");
-            }
-        } else {
-            safe_output(output, outputSize, "EMPTY_TEXT");
-        }
-        return;
+#ifdef BRIDGE_OFFLINE
+    const char* deviceBackend = "offline";
+#else
+    const char* deviceBackend = g_audioInitialized ? ma_get_backend_name(g_audioContext.backend) : "";
+#endif
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+        "{\"backend\":\"%s\",\"period_frames\":%d,\"periods\":%d,\"sample_rate\":%d,\"mode\":\"%s\","
+        "\"device\":{\"open\":%s,\"backend\":\"%s\",\"sample_rate\":%d,\"internal_rate\":%u,"
+        "\"period_frames\":%u,\"periods\":%u,\"exclusive\":%s}}",
+        AUDIO_BACKEND_NAMES[g_audioConfig.backend], g_audioConfig.periodFrames, g_audioConfig.periods,
+        g_audioConfig.sampleRate, g_audioConfig.exclusive ? "exclusive" : "shared",
+        g_audioInitialized ? "true" : "false", deviceBackend, g_sampleRate, g_deviceSampleRate.load(),
+        g_devicePeriodFrames.load(), g_devicePeriods.load(), g_audioExclusiveActive ? "true" : "false");
+    safe_output(output, outputSize, buf);
+}
+
+// Command: audio_stats - Render cost of the audio callback (JSON)
+// avg_us_per_512: mean render time normalized to a 512-frame buffer
+// load_pct: render time as a percentage of the audio it produced
+// render_hist: buffers by render time as a share of their duration (<10, <25, <50, <75,
+// <100, >=100 percent); overruns: the last bucket; late_callbacks: the device called more
+// than 1.5 buffers after the previous call (underrun); max_frames: largest buffer requested
+static void cmd_audio_stats(char* output, int outputSize, std::string_view args) {
+    AudioStatsSnapshot stats = read_audio_stats();
+
+    char buf[640];
+    snprintf(buf, sizeof(buf),
+        "{\"buffers\":%u,\"frames\":%llu,\"avg_us_per_512\":%.2f,\"max_us\":%.2f,\"load_pct\":%.3f,\"isa\":\"%s\","
+        "\"render_hist\":[%u,%u,%u,%u,%u,%u],\"overruns\":%u,\"late_callbacks\":%u,\"max_frames\":%u,"
+        "\"limited_frames\":%llu,\"max_reduction_db\":%.2f,\"duck_gain\":%.3f}",
+        stats.buffers, stats.frames, stats.avgUsPer512, stats.maxUs, stats.loadPct, g_synth->name,
+        stats.hist[0], stats.hist[1], stats.hist[2], stats.hist[3], stats.hist[4], stats.hist[5],
+        stats.overruns, stats.lateCallbacks, stats.maxFrames,
+        g_limiterFrames.load(std::memory_order_relaxed), g_limiterMaxReductionCdb.load(std::memory_order_relaxed) / 100.0,
+        g_duckGainMilli.load(std::memory_order_relaxed) / 1000.0);
+    safe_output(output, outputSize, buf);
+}
+
+// Periodic CSV dump of the audio stats for field profiling (one row per interval,
+// cumulative counters). Appends to nvda_arma3_bridge_audio_stats.csv next to the DLL.
+static const char* AUDIO_STATS_CSV_NAME = "nvda_arma3_bridge_audio_stats.csv";
+static std::atomic<int> g_audioCsvIntervalMs(0);          // 0 = off
+static std::atomic<bool> g_audioCsvThreadStarted(false);
+static std::atomic<bool> g_audioCsvShutdown(false);       // Set by DllMain: the worker returns
+
+static void append_audio_stats_csv(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "a");
+    if (!file) return;
+    if (ftell(file) == 0) {
+        fprintf(file, "time_s,buffers,frames,avg_us_per_512,max_us,load_pct,"
+                      "hist_lt10,hist_lt25,hist_lt50,hist_lt75,hist_lt100,hist_ge100,"
+                      "overruns,late_callbacks,max_frames\n");
     }
+    AudioStatsSnapshot stats = read_audio_stats();
+    fprintf(file, "%.3f,%u,%llu,%.2f,%.2f,%.3f,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+            now_us() / 1e6, stats.buffers, stats.frames, stats.avgUsPer512, stats.maxUs, stats.loadPct,
+            stats.hist[0], stats.hist[1], stats.hist[2], stats.hist[3], stats.hist[4], stats.hist[5],
+            stats.overruns, stats.lateCallbacks, stats.maxFrames);
+    fclose(file);
+}
 
-    // Command: cancel - Stop current speech
-    if (cmd == "cancel") {
-        error_status_t result = nvdaController_cancelSpeech();
-        if (result == 0) {
-            safe_output(output, outputSize, "OK");
-        } else {
-            safe_output(output, outputSize, "NVDA_ERROR");
+// Detached like the speech worker (start_worker_thread); idles while the interval is 0
+// and returns once DllMain sets g_audioCsvShutdown
+static void audio_stats_csv_worker() {
+    std::string path = module_file_path(AUDIO_STATS_CSV_NAME);
+    int waitedMs = 0;
+    while (!g_audioCsvShutdown.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (g_audioCsvShutdown.load()) return;
+        int intervalMs = g_audioCsvIntervalMs.load(std::memory_order_relaxed);
+        waitedMs = (intervalMs > 0) ? waitedMs + 100 : 0;
+        if (intervalMs > 0 && waitedMs >= intervalMs) {
+            append_audio_stats_csv(path);
+            waitedMs = 0;
         }
-        return;
     }
+}
 
-    // Command: braille:text - Send message to braille display
-    if (cmd.rfind("braille:", 0) == 0) {
-        std::string text = cmd.substr(8);
-        if (!text.empty()) {
-            std::wstring wtext = utf8_to_wstring(text);
-            error_status_t result = nvdaController_brailleMessage(wtext.c_str());
-            if (result == 0) {
-                safe_output(output, outputSize, "OK");
-            } else {
-                safe_output(output, outputSize, "NVDA_ERROR");
-            }
-        } else {
-            safe_output(output, outputSize, "EMPTY_TEXT");
+// Command: audio_stats_csv:seconds | audio_stats_csv:off - Append audio_stats to a CSV
+// next to the DLL every few seconds (0.1 - 3600)
+static void cmd_audio_stats_csv(char* output, int outputSize, std::string_view args) {
+    float seconds;
+    if (args == "off") {
+        g_audioCsvIntervalMs.store(0);
+    } else if (try_parse_float(args, seconds) && seconds >= 0.1f && seconds <= 3600.0f) {
+        g_audioCsvIntervalMs.store((int)(seconds * 1000.0f + 0.5f));
+        if (!g_audioCsvThreadStarted.exchange(true) && !start_worker_thread(audio_stats_csv_worker)) {
+            g_audioCsvThreadStarted.store(false);
         }
+    } else {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
+    safe_output(output, outputSize, "OK");
+}
 
-    // ========================================================================
-    // Aim Assist Audio Commands
-    // ========================================================================
-
-    // Command: aim_start - Initialize audio and start (silent) tone
-    if (cmd == "aim_start") {
-        if (init_audio()) {
-            g_aimPan.store(0.0f);
-            g_aimPitch.store(550.0f);
-            g_aimVertError.store(1.0f);   // Start at max error
-            g_aimHorizError.store(1.0f);  // Start at max error
-            g_aimMuted.store(true);       // Start muted until we have a target
-            g_aimActive.store(true);
-            g_chirpTime = 100.0f;         // Reset chirp (fully decayed)
-            g_prevPulseOn = false;
-            safe_output(output, outputSize, "OK");
-        } else {
-            safe_output(output, outputSize, "AUDIO_INIT_FAILED");
+// Command: latency_report - Control-to-render latency per command type (JSON)
+// render_ms: p50/p95/p99/max wait from the command to the start of the first buffer that
+// renders it (radar_beep: the buffer that starts the beep). device_ms: buffering between
+// the render and the speaker, as opened by miniaudio (period x periods, 0 before the
+// device is open); total_ms adds it to the render percentiles.
+static void cmd_latency_report(char* output, int outputSize, std::string_view args) {
+    unsigned int deviceRate = g_deviceSampleRate.load();
+    unsigned int periodFrames = g_devicePeriodFrames.load();
+    unsigned int periods = g_devicePeriods.load();
+    double deviceMs = deviceRate ? (double)periodFrames * periods * 1000.0 / deviceRate : 0.0;
+
+    char buf[1024];
+    int len = snprintf(buf, sizeof(buf), "{\"device_ms\":%.2f,\"period_frames\":%u,\"periods\":%u",
+                       deviceMs, periodFrames, periods);
+    for (int c = 0; c < LATENCY_COMMAND_COUNT; c++) {
+        unsigned int total = g_latencyCount[c].load(std::memory_order_acquire);
+        int samples = (total < (unsigned int)LATENCY_HISTORY) ? (int)total : LATENCY_HISTORY;
+        unsigned int sorted[LATENCY_HISTORY];
+        for (int i = 0; i < samples; i++) {
+            sorted[i] = g_latencyUs[c][i].load(std::memory_order_relaxed);
         }
+        std::sort(sorted, sorted + samples);
+
+        auto percentileMs = [&](int pct) -> double {
+            if (samples == 0) return 0.0;
+            int idx = (samples * pct + 99) / 100 - 1;
+            idx = (idx < 0) ? 0 : (idx >= samples) ? samples - 1 : idx;
+            return sorted[idx] / 1000.0;
+        };
+
+        double p50 = percentileMs(50), p95 = percentileMs(95), p99 = percentileMs(99);
+        double device = samples ? deviceMs : 0.0;
+        len += snprintf(buf + len, sizeof(buf) - len,
+            ",\"%s\":{\"samples\":%u,\"render_ms\":[%.3f,%.3f,%.3f,%.3f],\"total_ms\":[%.2f,%.2f,%.2f]}",
+            LATENCY_COMMAND_NAMES[c], total, p50, p95, p99, percentileMs(100),
+            p50 + device, p95 + device, p99 + device);
+    }
+    snprintf(buf + len, sizeof(buf) - len, "}");
+    safe_output(output, outputSize, buf);
+}
+
+// Command: bus_gain:bus,gain - Level of one mixer bus (aim, blip, radar, beacon or master)
+// gain: linear, 0 (mute) to MIX_GAIN_MAX; 1 = unchanged. Glides like the voice parameters.
+static void cmd_bus_gain(char* output, int outputSize, std::string_view args) {
+    std::string_view bus = next_field(args);
+    float gain;
+    if (!try_parse_float(args, gain) || gain < 0.0f || gain > MIX_GAIN_MAX) {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
 
-    // Command: aim_update:pan,pitch,vertError,horizError,vertThreshold,horizThreshold
-    // pan: -1.0 to 1.0 (left to right)
-    // pitch: frequency in Hz (typically 300-800, 550 = vertically centered)
-    // vertError: 0.0 to 1.0 (0 = dead center vertically)
-    // horizError: 0.0 to 1.0 (0 = dead center horizontally)
-    // vertThreshold: adaptive threshold based on target angular size
-    // horizThreshold: adaptive threshold based on target angular size
-    // Special: pitch of -1 means mute (no target)
-    if (cmd.rfind("aim_update:", 0) == 0) {
-        std::string params = cmd.substr(11);
-
-        // Parse comma-separated values: pan,pitch,vertError,horizError,vertThreshold,horizThreshold
-        float pan = 0.0f;
-        float pitch = 550.0f;
-        float vertError = 1.0f;
-        float horizError = 1.0f;
-        float vertThreshold = 0.02f;   // Default fallback
-        float horizThreshold = 0.005f; // Default fallback
-
-        size_t pos1 = params.find(',');
-        if (pos1 != std::string::npos) {
-            pan = parse_float(params.substr(0, pos1).c_str(), 0.0f);
-
-            size_t pos2 = params.find(',', pos1 + 1);
-            if (pos2 != std::string::npos) {
-                pitch = parse_float(params.substr(pos1 + 1, pos2 - pos1 - 1).c_str(), 550.0f);
-
-                size_t pos3 = params.find(',', pos2 + 1);
-                if (pos3 != std::string::npos) {
-                    vertError = parse_float(params.substr(pos2 + 1, pos3 - pos2 - 1).c_str(), 1.0f);
-
-                    size_t pos4 = params.find(',', pos3 + 1);
-                    if (pos4 != std::string::npos) {
-                        horizError = parse_float(params.substr(pos3 + 1, pos4 - pos3 - 1).c_str(), 1.0f);
-
-                        size_t pos5 = params.find(',', pos4 + 1);
-                        if (pos5 != std::string::npos) {
-                            vertThreshold = parse_float(params.substr(pos4 + 1, pos5 - pos4 - 1).c_str(), 0.02f);
-                            horizThreshold = parse_float(params.substr(pos5 + 1).c_str(), 0.005f);
-                        } else {
-                            vertThreshold = parse_float(params.substr(pos4 + 1).c_str(), 0.02f);
-                        }
-                    } else {
-                        horizError = parse_float(params.substr(pos3 + 1).c_str(), 1.0f);
-                    }
-                } else {
-                    vertError = parse_float(params.substr(pos2 + 1).c_str(), 1.0f);
-                }
-            } else {
-                pitch = parse_float(params.substr(pos1 + 1).c_str(), 550.0f);
-            }
+    MixerParams mixer = g_mixerParams.get();
+    if (bus == "master") {
+        mixer.masterGain = gain;
+    } else {
+        int index = -1;
+        for (int b = 0; b < MIX_BUS_COUNT; b++) {
+            if (bus == MIX_BUS_NAMES[b]) index = b;
         }
-
-        // Check for mute signal (pitch == -1)
-        if (pitch < 0) {
-            g_aimMuted.store(true);
-        } else {
-            g_aimMuted.store(false);
-
-            // Clamp values to valid ranges
-            pan = (pan < -1.0f) ? -1.0f : (pan > 1.0f) ? 1.0f : pan;
-            pitch = (pitch < 100.0f) ? 100.0f : (pitch > 2000.0f) ? 2000.0f : pitch;
-            vertError = (vertError < 0.0f) ? 0.0f : (vertError > 1.0f) ? 1.0f : vertError;
-            horizError = (horizError < 0.0f) ? 0.0f : (horizError > 1.0f) ? 1.0f : horizError;
-            vertThreshold = (vertThreshold < 0.001f) ? 0.001f : (vertThreshold > 0.5f) ? 0.5f : vertThreshold;
-            horizThreshold = (horizThreshold < 0.001f) ? 0.001f : (horizThreshold > 0.5f) ? 0.5f : horizThreshold;
-
-            g_aimPan.store(pan);
-            g_aimPitch.store(pitch);
-            g_aimVertError.store(vertError);
-            g_aimHorizError.store(horizError);
-            g_aimVertThreshold.store(vertThreshold);
-            g_aimHorizThreshold.store(horizThreshold);
+        if (index < 0) {
+            safe_output(output, outputSize, "BAD_ARGS");
+            return;
         }
+        mixer.busGain[index] = gain;
+    }
+    g_mixerParams.publish(mixer);
+    safe_output(output, outputSize, "OK");
+}
 
+// Command: duck:depthDb[,attackMs,holdMs,releaseMs,charsPerSec] | duck:off
+// Ducks the radar and beacon buses while NVDA speaks (default -12 dB, 30/300/500 ms, 15 chars/s).
+// depthDb: -60 to 0. charsPerSec: speaking rate used to estimate when plain speech ends.
+static void cmd_duck(char* output, int outputSize, std::string_view args) {
+    MixerParams mixer = g_mixerParams.get();
+    if (args == "off") {
+        mixer.duckEnabled = false;
+        g_mixerParams.publish(mixer);
         safe_output(output, outputSize, "OK");
         return;
     }
 
-    // Command: aim_blip - Play a one-shot vertical lock blip (800 Hz)
-    if (cmd == "aim_blip") {
-        g_aimBlipPending.store(true);
-        safe_output(output, outputSize, "OK");
+    float depthDb;
+    float attackMs = mixer.duckAttackMs;
+    float holdMs = mixer.duckHoldMs;
+    float releaseMs = mixer.duckReleaseMs;
+    float charsPerSec = (float)g_speechCharsPerSec.load(std::memory_order_relaxed);
+    std::string_view field = next_field(args);
+    bool valid = try_parse_float(field, depthDb) && depthDb >= -60.0f && depthDb <= 0.0f;
+    float* optional[] = { &attackMs, &holdMs, &releaseMs, &charsPerSec };
+    for (float* value : optional) {
+        if (!valid || args.empty()) break;
+        field = next_field(args);
+        valid = try_parse_float(field, *value) && *value >= 0.0f && *value <= 10000.0f;
+    }
+    if (!valid || !args.empty() || charsPerSec < 1.0f) {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
 
-    // Command: aim_unlock_blip - Play a one-shot vertical unlock blip (500 Hz)
-    if (cmd == "aim_unlock_blip") {
-        g_aimUnlockBlipPending.store(true);
-        safe_output(output, outputSize, "OK");
+    mixer.duckEnabled = true;
+    mixer.duckGain = powf(10.0f, depthDb / 20.0f);
+    mixer.duckAttackMs = attackMs;
+    mixer.duckHoldMs = holdMs;
+    mixer.duckReleaseMs = releaseMs;
+    g_speechCharsPerSec.store((int)(charsPerSec + 0.5f), std::memory_order_relaxed);
+    g_mixerParams.publish(mixer);
+    safe_output(output, outputSize, "OK");
+}
+
+// Command: limiter:ceilingDb | limiter:off - Master look-ahead limiter (default on, -1 dBFS)
+static void cmd_limiter(char* output, int outputSize, std::string_view args) {
+    MixerParams mixer = g_mixerParams.get();
+    float ceilingDb;
+    if (args == "off") {
+        mixer.limiterEnabled = false;
+    } else if (try_parse_float(args, ceilingDb) && ceilingDb >= LIMITER_CEILING_DB_MIN && ceilingDb <= 0.0f) {
+        mixer.limiterEnabled = true;
+        mixer.limiterCeiling = powf(10.0f, ceilingDb / 20.0f);
+    } else {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
+    g_mixerParams.publish(mixer);
+    safe_output(output, outputSize, "OK");
+}
 
-    // Command: aim_horiz_on - Enable horizontal guidance tone
-    if (cmd == "aim_horiz_on") {
-        g_aimHorizEnabled.store(true);
-        safe_output(output, outputSize, "OK");
+// Command: pan_law:constant_power|linear - Stereo pan law of the "pan" spatial mode
+static void cmd_pan_law(char* output, int outputSize, std::string_view args) {
+    if (args == "constant_power") {
+        g_panLaw.store(PAN_LAW_CONSTANT_POWER);
+    } else if (args == "linear") {
+        g_panLaw.store(PAN_LAW_LINEAR);
+    } else {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
+    safe_output(output, outputSize, "OK");
+}
 
-    // Command: aim_horiz_off - Disable horizontal guidance tone
-    if (cmd == "aim_horiz_off") {
-        g_aimHorizEnabled.store(false);
-        safe_output(output, outputSize, "OK");
+// Command: smoothing:ms - Ramp time for aim and beacon parameter changes
+// 0 = step changes at buffer boundaries; about one SQF update interval glides smoothly
+static void cmd_smoothing(char* output, int outputSize, std::string_view args) {
+    float rampMs = parse_float(args, PARAM_RAMP_DEFAULT_MS);
+    rampMs = (rampMs < 0.0f) ? 0.0f : (rampMs > PARAM_RAMP_MAX_MS) ? PARAM_RAMP_MAX_MS : rampMs;
+    g_paramRampSamples.store((int)(rampMs * g_sampleRate / 1000.0f), std::memory_order_relaxed);
+    safe_output(output, outputSize, "OK");
+}
+
+// Command: spatial:voice,mode - Spatial rendering per voice for A/B comparison
+// voice: aim, radar, beacon or all; mode: pan (stereo pan law, default) or binaural
+// (radar beeps already playing keep the mode they started with)
+static void cmd_spatial(char* output, int outputSize, std::string_view args) {
+    std::string_view voice = next_field(args);
+    int mode;
+    if (args == "pan") {
+        mode = SPATIAL_PAN;
+    } else if (args == "binaural") {
+        mode = SPATIAL_BINAURAL;
+    } else {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
 
-    // Command: aim_stop - Stop the tone and disable aim assist
-    if (cmd == "aim_stop") {
-        g_aimActive.store(false);
-        g_aimMuted.store(true);
-        g_aimHorizEnabled.store(false);
-        safe_output(output, outputSize, "OK");
-        return;
+    bool found = false;
+    for (int v = 0; v < SPATIAL_VOICE_COUNT; v++) {
+        if (voice == "all" || voice == SPATIAL_VOICE_NAMES[v]) {
+            g_spatialMode[v].store(mode, std::memory_order_relaxed);
+            found = true;
+        }
     }
+    safe_output(output, outputSize, found ? "OK" : "BAD_ARGS");
+}
 
-    // ========================================================================
-    // Terrain Radar Audio Commands
-    // ========================================================================
-
-    // Command: radar_start - Initialize audio for terrain radar
-    if (cmd == "radar_start") {
-        if (init_audio()) {
-            // Reset queue
-            g_radarQueueHead.store(0);
-            g_radarQueueTail.store(0);
-            // Reset playback state
-            g_radarPlayingPan = 0.0f;
-            g_radarPlayingVol = 0.5f;
-            g_radarPlayingMat = 0;
-            g_radarEnvState = 0;
-            g_radarEnvelope = 0.0f;
-            g_radarActive.store(true);
-            safe_output(output, outputSize, "OK");
-        } else {
-            safe_output(output, outputSize, "AUDIO_INIT_FAILED");
+#ifdef BRIDGE_BENCH
+// Command: synth_bench[:seconds] - Render each voice type for `seconds` (default 10) with
+// every kernel table this CPU supports; reports frames/sec and the largest difference from
+// the scalar output (JSON). Runs on the calling thread for up to several minutes, so it is
+// only compiled into bench builds (/DBRIDGE_BENCH, see bench_synth.cpp), never the shipped DLL.
+enum SynthBenchVoice { BENCH_AIM, BENCH_BLIP, BENCH_RADAR, BENCH_BEACON, BENCH_RADAR_BINAURAL, BENCH_VOICE_COUNT };
+static const char* const SYNTH_BENCH_VOICE_NAMES[BENCH_VOICE_COUNT] = { "aim", "blip", "radar", "beacon", "radar_binaural" };
+static const float SYNTH_BENCH_TOLERANCE = 1e-5f;  // Mix full scale is about 0.3
+
+// Fixed workload: aim/beacon parameters change every 100 ms (10Hz SQF updates),
+// blips and radar beeps play back to back (radar cycles through every material)
+static void synth_bench_render(int voice, const SynthKernels& k, int frames, float* left, float* right) {
+    const int bufferFrames = 512;
+    const int rampSamples = (int)(PARAM_RAMP_DEFAULT_MS * g_sampleRate / 1000);
+    AimVoice aim;
+    BlipVoice blip(BLIP_FREQ);
+    RadarVoice radar;
+    BeaconVoice beacon;
+    AimParams aimParams;
+    aimParams.active = true;
+    aimParams.horizEnabled = true;
+    BeaconParams beaconParams;
+    beaconParams.active = true;
+    int beepCount = 0;
+
+    memset(left, 0, frames * sizeof(float));
+    memset(right, 0, frames * sizeof(float));
+    for (int offset = 0; offset < frames; offset += bufferFrames) {
+        int bufferEnd = std::min(frames, offset + bufferFrames);
+        int update = offset / rampSamples;
+        aimParams.pan = -0.3f + 0.04f * (update % 16);
+        aimParams.pitch = 400.0f + 25.0f * (update % 13);
+        aimParams.vertError = 0.01f + 0.05f * (update % 9);
+        beaconParams.pan = -0.3f + 0.05f * (update % 13);
+        if (voice == BENCH_AIM) aim.begin_buffer(aimParams, rampSamples, bufferEnd - offset, 0, false);
+        if (voice == BENCH_BEACON) beacon.begin_buffer(beaconParams, rampSamples, false);
+
+        for (int block = offset; block < bufferEnd; block += SYNTH_BLOCK) {
+            int n = std::min(SYNTH_BLOCK, bufferEnd - block);
+            float* l = left + block;
+            float* r = right + block;
+            switch (voice) {
+                case BENCH_AIM:
+                    aim.render(k, l, r, n);
+                    break;
+                case BENCH_BLIP:
+                    for (int done = 0; done < n; ) {
+                        if (!blip.playing()) blip.start();
+                        done += blip.render(k, l + done, r + done, n - done);
+                    }
+                    break;
+                case BENCH_RADAR:
+                case BENCH_RADAR_BINAURAL:
+                    for (int done = 0; done < n; ) {
+                        if (!radar.playing()) {
+                            float pan = -0.8f + 0.2f * (beepCount % 9);
+                            RadarBeep beep = { pan, 0.8f, beepCount % 8, pan * BINAURAL_PAN_AZIMUTH, 0.0f, 0 };  // Not queued: no latency stamp
+                            radar.start(beep, voice == BENCH_RADAR_BINAURAL);
+                            beepCount++;
+                        }
+                        done += radar.render(k, l + done, r + done, n - done);
+                    }
+                    break;
+                case BENCH_BEACON:
+                    beacon.render(k, l, r, n);
+                    break;
+            }
         }
-        return;
     }
+}
 
-    // Command: radar_beep:pan,distance,material
-    // pan: -1.0 to 1.0 (left to right stereo position)
-    // distance: meters to target (used for volume calculation)
-    // material: grass, concrete, wood, metal, water, man, glass, default, none
-    if (cmd.rfind("radar_beep:", 0) == 0) {
-        std::string params = cmd.substr(11);
+static void cmd_synth_bench(char* output, int outputSize, std::string_view args) {
+    float seconds = parse_float(args, 10.0f);
+    seconds = (seconds < 0.1f) ? 0.1f : (seconds > 60.0f) ? 60.0f : seconds;
+    int frames = (int)(seconds * g_sampleRate);
+
+    const SynthKernels* tables[3];
+    int tableCount = supported_synth_kernels(tables);
+    std::vector<float> refLeft(frames), refRight(frames), left(frames), right(frames);
+    double framesPerSec[3][BENCH_VOICE_COUNT] = {};
+    float maxDiff[3] = {};
+
+    for (int voice = 0; voice < BENCH_VOICE_COUNT; voice++) {
+        for (int t = 0; t < tableCount; t++) {
+            // tables[0] is scalar: its output is the reference for the others
+            float* l = (t == 0) ? refLeft.data() : left.data();
+            float* r = (t == 0) ? refRight.data() : right.data();
+            long long start = now_ns();
+            synth_bench_render(voice, *tables[t], frames, l, r);
+            long long elapsedNs = now_ns() - start;
+            framesPerSec[t][voice] = (elapsedNs > 0) ? frames * 1e9 / (double)elapsedNs : 0.0;
+
+            for (int i = 0; t > 0 && i < frames; i++) {
+                maxDiff[t] = std::max(maxDiff[t], fabsf(l[i] - refLeft[i]));
+                maxDiff[t] = std::max(maxDiff[t], fabsf(r[i] - refRight[i]));
+            }
+        }
+    }
 
-        // Parse comma-separated values: pan,distance,material
-        float pan = 0.0f;
-        float distance = 50.0f;
-        std::string material = "default";
+    bool agree = true;
+    std::string json = "{\"isa\":\"" + std::string(g_synth->name) + "\",\"results\":[";
+    for (int t = 0; t < tableCount; t++) {
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%s{\"isa\":\"%s\"", (t > 0) ? "," : "", tables[t]->name);
+        json += buf;
+        for (int voice = 0; voice < BENCH_VOICE_COUNT; voice++) {
+            snprintf(buf, sizeof(buf), ",\"%s\":%.0f", SYNTH_BENCH_VOICE_NAMES[voice], framesPerSec[t][voice]);
+            json += buf;
+        }
+        snprintf(buf, sizeof(buf), ",\"max_diff\":%g}", maxDiff[t]);
+        json += buf;
+        if (maxDiff[t] > SYNTH_BENCH_TOLERANCE) agree = false;
+    }
+    char tail[128];
+    snprintf(tail, sizeof(tail), "],\"seconds\":%g,\"tolerance\":%g,\"agree\":%s}",
+        seconds, SYNTH_BENCH_TOLERANCE, agree ? "true" : "false");
+    json += tail;
+    safe_output(output, outputSize, json.c_str());
+}
+#endif
 
-        size_t pos1 = params.find(',');
-        if (pos1 != std::string::npos) {
-            pan = parse_float(params.substr(0, pos1).c_str(), 0.0f);
+// ============================================================================
+// Command Dispatch Table
+// ============================================================================
 
-            size_t pos2 = params.find(',', pos1 + 1);
-            if (pos2 != std::string::npos) {
-                distance = parse_float(params.substr(pos1 + 1, pos2 - pos1 - 1).c_str(), 50.0f);
-                material = params.substr(pos2 + 1);
-            } else {
-                distance = parse_float(params.substr(pos1 + 1).c_str(), 50.0f);
-            }
-        }
+struct CommandEntry {
+    std::string_view name;
+    CommandHandler handler;
+};
 
-        // Clamp pan
-        pan = (pan < -1.0f) ? -1.0f : (pan > 1.0f) ? 1.0f : pan;
+// Sorted by name so lookup is a binary search (enforced at compile time below)
+static constexpr CommandEntry COMMAND_TABLE[] = {
+    { "aim_blip",        cmd_aim_blip },
+    { "aim_horiz_off",   cmd_aim_horiz_off },
+    { "aim_horiz_on",    cmd_aim_horiz_on },
+    { "aim_start",       cmd_aim_start },
+    { "aim_stop",        cmd_aim_stop },
+    { "aim_unlock_blip", cmd_aim_unlock_blip },
+    { "aim_update",      cmd_aim_update },
+    { "audio_config",    cmd_audio_config },
+    { "audio_stats",     cmd_audio_stats },
+    { "audio_stats_csv", cmd_audio_stats_csv },
+    { "beacon_start",    cmd_beacon_start },
+    { "beacon_stop",     cmd_beacon_stop },
+    { "beacon_update",   cmd_beacon_update },
+    { "braille",         cmd_braille },
+    { "bus_gain",        cmd_bus_gain },
+    { "cancel",          cmd_cancel },
+    { "duck",            cmd_duck },
+    { "latency_report",  cmd_latency_report },
+    { "limiter",         cmd_limiter },
+    { "material",        cmd_material },
+    { "pan_law",         cmd_pan_law },
+    { "radar_beep",      cmd_radar_beep },
+    { "radar_overflow",  cmd_radar_overflow },
+    { "radar_start",     cmd_radar_start },
+    { "radar_stats",     cmd_radar_stats },
+    { "radar_steal",     cmd_radar_steal },
+    { "radar_stop",      cmd_radar_stop },
+    { "radar_sweep_hit", cmd_radar_sweep_hit },
+    { "radar_sweep_pos", cmd_radar_sweep_pos },
+    { "radar_sweep_start", cmd_radar_sweep_start },
+    { "radar_sweep_stop", cmd_radar_sweep_stop },
+    { "smoothing",       cmd_smoothing },
+    { "spatial",         cmd_spatial },
+    { "speak",           cmd_speak },
+    { "speech_poll",     cmd_speech_poll },
+    { "speech_stats",    cmd_speech_stats },
+#ifdef BRIDGE_BENCH
+    { "synth_bench",     cmd_synth_bench },
+#endif
+    { "test",            cmd_test },
+};
+static const int COMMAND_COUNT = (int)(sizeof(COMMAND_TABLE) / sizeof(COMMAND_TABLE[0]));
 
-        // Calculate volume using logarithmic distance falloff
-        // Volume is loud at 0.5m, very quiet at 100m
-        float loudDist = 0.5f;
-        float quietDist = 100.0f;
-        float clampedDist = (distance < loudDist) ? loudDist : (distance > quietDist) ? quietDist : distance;
-        float logRange = logf(quietDist) - logf(loudDist);  // ~5.3
-        float volume = 1.0f - (logf(clampedDist) - logf(loudDist)) / logRange;
-        volume = (volume < 0.02f) ? 0.02f : volume;  // Floor at 2% for audibility
-
-        // Map material string to code
-        // 0=default, 1=grass, 2=concrete, 3=wood, 4=metal, 5=water, 6=man, 7=glass, -1=none (silent)
-        int matCode = 0;
-        if (material == "grass" || material == "soil" || material == "sand" || material == "dirt") {
-            matCode = 1;
-        } else if (material == "concrete" || material == "asphalt" || material == "rock" || material == "stone") {
-            matCode = 2;
-        } else if (material == "wood" || material == "wood_planks") {
-            matCode = 3;
-        } else if (material == "metal" || material == "metal_plate") {
-            matCode = 4;
-        } else if (material == "water") {
-            matCode = 5;
-        } else if (material == "man") {
-            matCode = 6;
-        } else if (material == "glass") {
-            matCode = 7;
-        } else if (material == "none") {
-            matCode = -1;  // Silent - no beep
-        }
-
-        // Only queue beep if not "none" and radar is active
-        if (matCode >= 0 && g_radarActive.load()) {
-            // Add beep to queue
-            int head = g_radarQueueHead.load(std::memory_order_relaxed);
-            int nextHead = (head + 1) % RADAR_QUEUE_SIZE;
-
-            // Store beep parameters in queue
-            g_radarQueue[head].pan = pan;
-            g_radarQueue[head].volume = volume;
-            g_radarQueue[head].material = matCode;
-
-            // Publish the new head (makes beep visible to audio callback)
-            g_radarQueueHead.store(nextHead, std::memory_order_release);
-        }
+static constexpr bool command_table_sorted() {
+    for (size_t i = 1; i < sizeof(COMMAND_TABLE) / sizeof(COMMAND_TABLE[0]); i++) {
+        if (!(COMMAND_TABLE[i - 1].name < COMMAND_TABLE[i].name)) return false;
+    }
+    return true;
+}
+static_assert(command_table_sorted(), "COMMAND_TABLE must be sorted by name with no duplicates");
+
+// Look up a command handler by name (nullptr if unknown)
+static CommandHandler find_command(std::string_view name) {
+    int lo = 0;
+    int hi = COMMAND_COUNT - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = name.compare(COMMAND_TABLE[mid].name);
+        if (cmp == 0) return COMMAND_TABLE[mid].handler;
+        if (cmp < 0) hi = mid - 1; else lo = mid + 1;
+    }
+    return nullptr;
+}
 
-        safe_output(output, outputSize, "OK");
+// ============================================================================
+// Arma 3 Extension Entry Points
+// ============================================================================
+
+// Return the extension version
+void __stdcall RVExtensionVersion(char *output, int outputSize) {
+    safe_output(output, outputSize, VERSION);
+}
+
+// Main extension entry point (single argument as string)
+// Commands are "name" or "name:args"; the name is looked up in COMMAND_TABLE
+// and the handler parses args in place (no allocation for audio commands).
+void __stdcall RVExtension(char *output, int outputSize, const char *function) {
+    if (!function || !output || outputSize <= 0) {
         return;
     }
 
-    // Command: radar_stop - Stop terrain radar audio
-    if (cmd == "radar_stop") {
-        g_radarActive.store(false);
-        // Clear queue
-        g_radarQueueHead.store(0);
-        g_radarQueueTail.store(0);
-        g_radarEnvState = 0;
-        g_radarEnvelope = 0.0f;
-        safe_output(output, outputSize, "OK");
+    std::string_view cmd(function);
+    std::string_view name = cmd;
+    std::string_view args;
+
+    size_t colon = cmd.find(':');
+    if (colon != std::string_view::npos) {
+        name = cmd.substr(0, colon);
+        args = cmd.substr(colon + 1);
+    }
+
+    CommandHandler handler = find_command(name);
+    if (handler) {
+        handler(output, outputSize, args);
         return;
     }
 
-    // ========================================================================
-    // Navigation Beacon Audio Commands
-    // ========================================================================
-
-    // Command: beacon_start - Initialize audio and start beacon
-    if (cmd == "beacon_start") {
-        if (init_audio()) {
-            g_beaconPan.store(0.0f);
-            g_beaconPhase = 0.0;
-            g_beaconPulsePhase = 0.0;
-            g_beaconLpfState = 0.0f;
-            g_beaconEnvelopeState = 0.0f;
-            g_beaconActive.store(true);
-            safe_output(output, outputSize, "OK");
-        } else {
-            safe_output(output, outputSize, "AUDIO_INIT_FAILED");
+    // Unknown command
+    safe_output(output, outputSize, "UNKNOWN_COMMAND");
+}
+
+// ============================================================================
+// Typed Array-Argument Commands (RVExtensionArgs)
+// ============================================================================
+
+// Numeric result codes returned by RVExtensionArgs. SQF reads them as the second
+// element of callExtension's array result and can branch without string compares.
+enum BridgeResult {
+    RESULT_OK = 0,                  // "OK", "QUEUED" or a data reply (stats, poll)
+    RESULT_UNKNOWN_COMMAND = 1,
+    RESULT_BAD_ARGS = 2,            // Wrong argument count or a non-numeric number
+    RESULT_EMPTY_TEXT = 3,
+    RESULT_QUEUE_FULL = 4,
+    RESULT_AUDIO_INIT_FAILED = 5,
+    RESULT_SPEECH_INIT_FAILED = 6,
+    RESULT_NVDA_NOT_RUNNING = 7,
+    RESULT_FULL = 8,                // radar_beep queued, but an older beep was dropped/merged
+    RESULT_DROPPED = 9,             // radar_beep discarded (queue full, drop_newest)
+    RESULT_SAVE_FAILED = 10         // audio_config:save could not write the file
+};
+
+// Map a handler's text reply to its result code (anything not listed is a success reply)
+static int result_code(const char* output) {
+    static const struct { const char* text; int code; } RESULT_TEXTS[] = {
+        { "UNKNOWN_COMMAND",    RESULT_UNKNOWN_COMMAND },
+        { "BAD_ARGS",           RESULT_BAD_ARGS },
+        { "EMPTY_TEXT",         RESULT_EMPTY_TEXT },
+        { "QUEUE_FULL",         RESULT_QUEUE_FULL },
+        { "AUDIO_INIT_FAILED",  RESULT_AUDIO_INIT_FAILED },
+        { "SPEECH_INIT_FAILED", RESULT_SPEECH_INIT_FAILED },
+        { "NVDA_NOT_RUNNING",   RESULT_NVDA_NOT_RUNNING },
+        { "FULL",               RESULT_FULL },
+        { "DROPPED",            RESULT_DROPPED },
+        { "SAVE_FAILED",        RESULT_SAVE_FAILED },
+    };
+    for (const auto& entry : RESULT_TEXTS) {
+        if (strcmp(output, entry.text) == 0) return entry.code;
+    }
+    return RESULT_OK;
+}
+
+// Handler signature for array-argument commands (args as passed by Arma: strings quoted)
+typedef void (*ArgsCommandHandler)(char* output, int outputSize, const char** args, int argsCnt);
+
+// Parse args[first..first+count) as floats into values; false if any is not a number
+static bool parse_float_args(const char** args, int argsCnt, int first, float* values, int count) {
+    for (int i = 0; i < count && first + i < argsCnt; i++) {
+        if (!try_parse_float(args[first + i], values[i])) return false;
+    }
+    return true;
+}
+
+// Command: speak with array args - speak all arguments concatenated
+static void args_speak(char* output, int outputSize, const char** args, int argsCnt) {
+    std::string fullText;
+    for (int i = 0; i < argsCnt; i++) {
+        if (args[i]) {
+            if (!fullText.empty()) fullText += " ";
+            fullText += unquote_arg(args[i]);
         }
+    }
+    if (!fullText.empty()) {
+        safe_output(output, outputSize, speech_enqueue(SPEECH_CMD_SPEAK, utf8_to_wstring(fullText)));
+    } else {
+        safe_output(output, outputSize, "EMPTY_TEXT");
+    }
+}
+
+// Command: speak_priority with array args - [text, priority, key, maxAge]
+// priority: "normal" (default), "next" (ahead of normal) or "now" (interrupts current speech)
+// key: coalescing key - unsent speech with the same key is replaced by this one ("" = none)
+// maxAge: seconds after which unsent speech is stale and dropped (0 = never)
+static void args_speak_priority(char* output, int outputSize, const char** args, int argsCnt) {
+    std::string text = (argsCnt > 0) ? unquote_arg(args[0]) : std::string();
+    std::string priority = (argsCnt > 1) ? unquote_arg(args[1]) : std::string();
+    std::string key = (argsCnt > 2) ? unquote_arg(args[2]) : std::string();
+    float maxAge = (argsCnt > 3) ? parse_float(args[3], 0.0f) : 0.0f;
+
+    if (!text.empty()) {
+        safe_output(output, outputSize, speech_enqueue(SPEECH_CMD_SPEAK, utf8_to_wstring(text),
+            parse_speech_priority(priority.c_str()), key.c_str(), maxAge));
+    } else {
+        safe_output(output, outputSize, "EMPTY_TEXT");
+    }
+}
+
+// Command: speak_ssml with array args - [text, rateBoost, pitchBoost, mark, priority, key, maxAge]
+// rateBoost/pitchBoost: percent added to NVDA's rate/pitch (e.g. 30 = 130%), 0 = unchanged
+// mark: SSML mark name placed after the text ("" = none)
+// priority/key/maxAge: as for speak_priority (priority is passed through to NVDA)
+// Falls back to plain speakText when NVDA lacks the NvdaController2 interface
+static void args_speak_ssml(char* output, int outputSize, const char** args, int argsCnt) {
+    std::string text = (argsCnt > 0) ? unquote_arg(args[0]) : std::string();
+    int rateBoost = (argsCnt > 1) ? (int)parse_float(args[1], 0.0f) : 0;
+    int pitchBoost = (argsCnt > 2) ? (int)parse_float(args[2], 0.0f) : 0;
+    std::string mark = (argsCnt > 3) ? unquote_arg(args[3]) : std::string();
+    std::string priority = (argsCnt > 4) ? unquote_arg(args[4]) : std::string();
+    std::string key = (argsCnt > 5) ? unquote_arg(args[5]) : std::string();
+    float maxAge = (argsCnt > 6) ? parse_float(args[6], 0.0f) : 0.0f;
+
+    // Keep prosody within a range every synthesizer handles sensibly
+    rateBoost = (rateBoost < -50) ? -50 : (rateBoost > 100) ? 100 : rateBoost;
+    pitchBoost = (pitchBoost < -50) ? -50 : (pitchBoost > 100) ? 100 : pitchBoost;
+
+    if (!text.empty()) {
+        safe_output(output, outputSize, speech_enqueue(SPEECH_CMD_SSML, utf8_to_wstring(text),
+            parse_speech_priority(priority.c_str()), key.c_str(), maxAge,
+            rateBoost, pitchBoost, utf8_to_wstring(mark)));
+    } else {
+        safe_output(output, outputSize, "EMPTY_TEXT");
+    }
+}
+
+// Command: aim_update with array args -
+//   [pan, pitch, vertError, horizError, vertThreshold, horizThreshold, panVel, vertErrVel, time]
+// Same meaning and defaults as the string form; at least pan and pitch are required
+static void args_aim_update(char* output, int outputSize, const char** args, int argsCnt) {
+    float values[8] = { 0.0f, 550.0f, 1.0f, 1.0f, 0.02f, 0.005f, 0.0f, 0.0f };
+    if (argsCnt < 2 || argsCnt > 8 || !parse_float_args(args, argsCnt, 0, values, 8)) {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
 
-    // Command: beacon_update:pan - Update beacon pan value
-    // pan: -1.0 (left) to +1.0 (right)
-    if (cmd.rfind("beacon_update:", 0) == 0) {
-        std::string params = cmd.substr(14);
-        float pan = parse_float(params.c_str(), 0.0f);
+    apply_aim_update(values[0], values[1], values[2], values[3], values[4], values[5],
+                     values[6], values[7]);
+    safe_output(output, outputSize, "OK");
+}
 
-        // Clamp pan to valid range
-        pan = (pan < -1.0f) ? -1.0f : (pan > 1.0f) ? 1.0f : pan;
+// Command: radar_beep with array args - [pan, distance, material, azimuth, elevation]
+// azimuth/elevation (degrees, optional) place the beep for binaural rendering
+static void args_radar_beep(char* output, int outputSize, const char** args, int argsCnt) {
+    float values[2] = { 0.0f, 50.0f };
+    float direction[2] = { 0.0f, 0.0f };
+    if (argsCnt < 3 || argsCnt > 5 || !parse_float_args(args, argsCnt, 0, values, 2) ||
+        !parse_float_args(args, argsCnt, 3, direction, 2)) {
+        safe_output(output, outputSize, "BAD_ARGS");
+        return;
+    }
 
-        g_beaconPan.store(pan);
-        safe_output(output, outputSize, "OK");
+    safe_output(output, outputSize, queue_radar_beep(values[0], values[1], arg_view(args[2]),
+                                                     (argsCnt > 3) ? direction : nullptr));
+}
+
+// Command: radar_sweep_hit with array args - [sample, pan, distance, material, azimuth, elevation]
+static void args_radar_sweep_hit(char* output, int outputSize, const char** args, int argsCnt) {
+    float values[3] = { 0.0f, 0.0f, 50.0f };
+    float direction[2] = { 0.0f, 0.0f };
+    if (argsCnt < 4 || argsCnt > 6 || !parse_float_args(args, argsCnt, 0, values, 3) ||
+        !parse_float_args(args, argsCnt, 4, direction, 2) ||
+        !apply_radar_sweep_hit((int)values[0], values[1], values[2], arg_view(args[3]),
+                               (argsCnt > 4) ? direction : nullptr)) {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
+    safe_output(output, outputSize, "OK");
+}
 
-    // Command: beacon_stop - Stop navigation beacon
-    if (cmd == "beacon_stop") {
-        g_beaconActive.store(false);
-        g_beaconEnvelopeState = 0.0f;
-        safe_output(output, outputSize, "OK");
+// Command: beacon_update with array args - [pan, azimuth, elevation]
+static void args_beacon_update(char* output, int outputSize, const char** args, int argsCnt) {
+    float pan = 0.0f;
+    float direction[2] = { 0.0f, 0.0f };
+    if (argsCnt < 1 || argsCnt > 3 || !try_parse_float(args[0], pan) ||
+        !parse_float_args(args, argsCnt, 1, direction, 2)) {
+        safe_output(output, outputSize, "BAD_ARGS");
         return;
     }
 
-    // Unknown command
-    safe_output(output, outputSize, "UNKNOWN_COMMAND");
+    apply_beacon_update(pan, (argsCnt > 1) ? direction : nullptr);
+    safe_output(output, outputSize, "OK");
 }
 
-// Extended entry point with array arguments (for future use)
-int __stdcall RVExtensionArgs(char *output, int outputSize, const char *function, const char **args, int argsCnt) {
-    // For now, just delegate to the simple version
-    // In the future, this could handle commands with multiple arguments
+static void args_frame(char* output, int outputSize, const char** args, int argsCnt);
 
-    if (!function || !output || outputSize <= 0) {
-        return 0;
+struct ArgsCommandEntry {
+    std::string_view name;
+    ArgsCommandHandler handler;
+};
+
+// Sorted by name, like COMMAND_TABLE
+static constexpr ArgsCommandEntry ARGS_COMMAND_TABLE[] = {
+    { "aim_update",     args_aim_update },
+    { "beacon_update",  args_beacon_update },
+    { "frame",          args_frame },
+    { "radar_beep",     args_radar_beep },
+    { "radar_sweep_hit", args_radar_sweep_hit },
+    { "speak",          args_speak },
+    { "speak_priority", args_speak_priority },
+    { "speak_ssml",     args_speak_ssml },
+};
+
+static constexpr bool args_command_table_sorted() {
+    for (size_t i = 1; i < sizeof(ARGS_COMMAND_TABLE) / sizeof(ARGS_COMMAND_TABLE[0]); i++) {
+        if (!(ARGS_COMMAND_TABLE[i - 1].name < ARGS_COMMAND_TABLE[i].name)) return false;
+    }
+    return true;
+}
+static_assert(args_command_table_sorted(), "ARGS_COMMAND_TABLE must be sorted by name with no duplicates");
+
+static const int ARGS_COMMAND_COUNT = (int)(sizeof(ARGS_COMMAND_TABLE) / sizeof(ARGS_COMMAND_TABLE[0]));
+
+// Binary search, as find_command
+static ArgsCommandHandler find_args_command(std::string_view name) {
+    int lo = 0;
+    int hi = ARGS_COMMAND_COUNT - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = name.compare(ARGS_COMMAND_TABLE[mid].name);
+        if (cmp == 0) return ARGS_COMMAND_TABLE[mid].handler;
+        if (cmp < 0) hi = mid - 1; else lo = mid + 1;
     }
+    return nullptr;
+}
 
-    std::string cmd(function);
+// Frame packet limits (Arma's own argument limits are far larger; a frame is a few updates)
+static const int FRAME_MAX_COMMANDS = 32;
+static const int FRAME_MAX_COMMAND_LENGTH = 512;
+static const int FRAME_MAX_COMMAND_ARGS = 12;
+
+// Run one sub-command of a frame (an SQF array ["name", args...]); returns its result code
+static int frame_run_command(const char* packed) {
+    char command[FRAME_MAX_COMMAND_LENGTH];
+    size_t length = strlen(packed);
+    if (length >= sizeof(command)) return RESULT_BAD_ARGS;
+    memcpy(command, packed, length + 1);
+
+    const char* elements[FRAME_MAX_COMMAND_ARGS];
+    int count = split_sqf_array(command, elements, FRAME_MAX_COMMAND_ARGS);
+    if (count < 1) return RESULT_BAD_ARGS;
+
+    std::string_view name = arg_view(elements[0]);
+    if (name == "frame") return RESULT_BAD_ARGS;  // No nested frames
+
+    // Sub-commands with arguments use the typed handlers; bare ones (aim_blip...) the string table
+    char reply[64];
+    reply[0] = '\0';
+    if (count > 1) {
+        ArgsCommandHandler handler = find_args_command(name);
+        if (!handler) return RESULT_UNKNOWN_COMMAND;
+        handler(reply, sizeof(reply), elements + 1, count - 1);
+    } else {
+        CommandHandler handler = find_command(name);
+        if (!handler) return RESULT_UNKNOWN_COMMAND;
+        handler(reply, sizeof(reply), std::string_view());
+    }
+    return result_code(reply);
+}
 
-    // Command: speak with array args - speak all arguments concatenated
-    if (cmd == "speak" && argsCnt > 0) {
-        std::string fullText;
-        for (int i = 0; i < argsCnt; i++) {
-            if (args[i]) {
-                if (!fullText.empty()) fullText += " ";
-                fullText += args[i];
-            }
-        }
-        if (!fullText.empty()) {
-            std::wstring wtext = utf8_to_wstring(fullText);
-            error_status_t result = nvdaController_speakText(wtext.c_str());
-            if (result == 0) {
-                safe_output(output, outputSize, "OK");
-            } else {
-                safe_output(output, outputSize, "NVDA_ERROR");
-            }
-        } else {
-            safe_output(output, outputSize, "EMPTY_TEXT");
-        }
-        return 0;
+// Command: frame with array args - [[name, args...], [name, args...], ...]
+// Applies several sub-commands in one callExtension crossing. The audio callback sees
+// either none or all of their parameter changes (see read_control_snapshot); blips, queued
+// radar beeps and radar resets wait until the frame ends (frame_gate_open).
+// Output is the per-sub-command result codes in order, e.g. "[0,0,2]" (BridgeResult values).
+static void args_frame(char* output, int outputSize, const char** args, int argsCnt) {
+    if (argsCnt > FRAME_MAX_COMMANDS) {
+        safe_output(output, outputSize, "BAD_ARGS");
+        return;
     }
 
-    // Fall back to simple version for other commands
-    RVExtension(output, outputSize, function);
-    return 0;
+    int codes[FRAME_MAX_COMMANDS];
+    g_controlSeq.fetch_add(1, std::memory_order_acq_rel);  // Odd: frame in progress
+    for (int i = 0; i < argsCnt; i++) {
+        codes[i] = frame_run_command(args[i]);
+    }
+    g_controlSeq.fetch_add(1, std::memory_order_release);  // Even: frame published
+
+    char status[FRAME_MAX_COMMANDS * 3 + 3];
+    int pos = 0;
+    status[pos++] = '[';
+    for (int i = 0; i < argsCnt; i++) {
+        if (i > 0) status[pos++] = ',';
+        pos += snprintf(status + pos, sizeof(status) - pos, "%d", codes[i]);
+    }
+    status[pos++] = ']';
+    status[pos] = '\0';
+    safe_output(output, outputSize, status);
+}
+
+// Extended entry point with array arguments
+// "name" callExtension ["cmd", [args...]] - typed commands take their parameters as
+// real array elements; anything else falls back to the string form (args ignored).
+// Returns a BridgeResult code alongside the usual text reply.
+int __stdcall RVExtensionArgs(char *output, int outputSize, const char *function, const char **args, int argsCnt) {
+    if (!function || !output || outputSize <= 0) {
+        return RESULT_BAD_ARGS;
+    }
+
+    ArgsCommandHandler handler = (args && argsCnt > 0) ? find_args_command(function) : nullptr;
+    if (handler) {
+        handler(output, outputSize, args, argsCnt);
+    } else {
+        RVExtension(output, outputSize, function);
+    }
+    return result_code(output);
+}
+
+// Arma passes its callback entry once on load; used to raise speech_mark events
+void __stdcall RVExtensionRegisterCallback(int(*callbackProc)(char const *name, char const *function, char const *data)) {
+    g_armaCallback.store(callbackProc);
 }
 
+#ifndef BRIDGE_OFFLINE
 // DLL entry point
 BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID lpReserved) {
     switch (reason) {
@@ -1237,9 +5490,13 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID lpReserved) {
         case DLL_THREAD_DETACH:
             break;
         case DLL_PROCESS_DETACH:
-            // Clean up audio on DLL unload
+            // Clean up audio and the workers (reached once no worker pins the DLL, or at process exit)
+            g_audioCsvIntervalMs.store(0);
+            g_audioCsvShutdown.store(true);
             shutdown_audio();
+            shutdown_speech();
             break;
     }
     return TRUE;
 }
+#endif
@@ -0,0 +1,193 @@
+/*
+ * Offline platform layer for the NVDA-Arma 3 Bridge
+ *
+ * Included instead of windows.h, nvdaController.h and miniaudio.h when the bridge
+ * is compiled with BRIDGE_OFFLINE (the Linux render harness, see render_timeline.cpp).
+ * Provides the handful of Win32 calls the bridge makes and a silent NVDA that
+ * accepts every call (and reports SSML marks), so the same command handlers and
+ * synth run unchanged.
+ * No audio device is opened: the harness renders buffers itself.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <cwchar>
+#include <string>
+#include <strings.h>
+#include <mutex>
+#include <condition_variable>
+
+// ============================================================================
+// Win32
+// ============================================================================
+
+#define __stdcall
+#define __declspec(x)
+#define APIENTRY
+
+typedef int BOOL;
+typedef unsigned long DWORD;
+typedef void* HANDLE;
+#define TRUE 1
+#define FALSE 0
+#define INFINITE 0xFFFFFFFF
+#define CP_UTF8 65001
+#define _TRUNCATE ((size_t)-1)
+
+// UTF-8 to wide (UTF-32 here); returns the character count (out == NULL: just count)
+inline int MultiByteToWideChar(unsigned int codePage, DWORD flags, const char* str, int length,
+                               wchar_t* out, int outSize) {
+    (void)codePage;
+    (void)flags;
+    const unsigned char* s = (const unsigned char*)str;
+    int count = 0;
+    for (int i = 0; i < length; count++) {
+        unsigned int c = s[i];
+        int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+        c &= (extra == 3) ? 0x07 : (extra == 2) ? 0x0F : (extra == 1) ? 0x1F : 0x7F;
+        i++;
+        for (; extra > 0 && i < length && (s[i] & 0xC0) == 0x80; extra--, i++) {
+            c = (c << 6) | (s[i] & 0x3F);
+        }
+        if (out) {
+            if (count >= outSize) return 0;
+            out[count] = (wchar_t)c;
+        }
+    }
+    return count;
+}
+
+// Wide to UTF-8 (length -1: terminated input, terminator included); 0 if out is too small
+inline int WideCharToMultiByte(unsigned int codePage, DWORD flags, const wchar_t* str, int length,
+                               char* out, int outSize, const char* defaultChar, BOOL* usedDefault) {
+    (void)codePage;
+    (void)flags;
+    (void)defaultChar;
+    (void)usedDefault;
+    if (length < 0) length = (int)wcslen(str) + 1;
+    int written = 0;
+    for (int i = 0; i < length; i++) {
+        unsigned int c = (unsigned int)str[i];
+        unsigned char bytes[4];
+        int n = 0;
+        if (c < 0x80) {
+            bytes[n++] = (unsigned char)c;
+        } else if (c < 0x800) {
+            bytes[n++] = (unsigned char)(0xC0 | (c >> 6));
+            bytes[n++] = (unsigned char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            bytes[n++] = (unsigned char)(0xE0 | (c >> 12));
+            bytes[n++] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+            bytes[n++] = (unsigned char)(0x80 | (c & 0x3F));
+        } else {
+            bytes[n++] = (unsigned char)(0xF0 | (c >> 18));
+            bytes[n++] = (unsigned char)(0x80 | ((c >> 12) & 0x3F));
+            bytes[n++] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+            bytes[n++] = (unsigned char)(0x80 | (c & 0x3F));
+        }
+        if (written + n > outSize) return 0;
+        memcpy(out + written, bytes, n);
+        written += n;
+    }
+    return written;
+}
+
+inline int strncpy_s(char* dest, size_t destSize, const char* src, size_t count) {
+    (void)count;  // Always _TRUNCATE here
+    size_t n = strlen(src);
+    if (n >= destSize) n = destSize - 1;
+    memcpy(dest, src, n);
+    dest[n] = '\0';
+    return 0;
+}
+
+inline int _stricmp(const char* a, const char* b) {
+    return strcasecmp(a, b);
+}
+
+// Auto-reset event (the only kind the bridge creates)
+struct OfflineEvent {
+    std::mutex mutex;
+    std::condition_variable signal;
+    bool set = false;
+};
+
+inline HANDLE CreateEventW(void* attributes, BOOL manualReset, BOOL initialState, const wchar_t* name) {
+    (void)attributes;
+    (void)manualReset;
+    (void)name;
+    OfflineEvent* event = new OfflineEvent();
+    event->set = initialState != FALSE;
+    return event;
+}
+
+inline BOOL SetEvent(HANDLE handle) {
+    OfflineEvent* event = (OfflineEvent*)handle;
+    {
+        std::lock_guard<std::mutex> lock(event->mutex);
+        event->set = true;
+    }
+    event->signal.notify_one();
+    return TRUE;
+}
+
+inline DWORD WaitForSingleObject(HANDLE handle, DWORD milliseconds) {
+    (void)milliseconds;  // Always INFINITE here
+    OfflineEvent* event = (OfflineEvent*)handle;
+    std::unique_lock<std::mutex> lock(event->mutex);
+    event->signal.wait(lock, [event]() { return event->set; });
+    event->set = false;
+    return 0;
+}
+
+// ============================================================================
+// NVDA Controller (silent: every call succeeds, nothing is spoken)
+// ============================================================================
+
+typedef unsigned long error_status_t;
+typedef unsigned char boolean;
+
+typedef enum tagSPEECH_PRIORITY {
+    SPEECH_PRIORITY_NORMAL = 0,
+    SPEECH_PRIORITY_NEXT = 1,
+    SPEECH_PRIORITY_NOW = 2
+} SPEECH_PRIORITY;
+
+typedef enum tagSYMBOL_LEVEL {
+    SYMBOL_LEVEL_UNCHANGED = -1
+} SYMBOL_LEVEL;
+
+typedef error_status_t (*onSsmlMarkReachedFuncType)(const wchar_t* mark);
+
+inline error_status_t nvdaController_testIfRunning() { return 0; }
+inline error_status_t nvdaController_speakText(const wchar_t*) { return 0; }
+inline error_status_t nvdaController_cancelSpeech() { return 0; }
+inline error_status_t nvdaController_brailleMessage(const wchar_t*) { return 0; }
+inline error_status_t nvdaController_getProcessId(unsigned long* pid) { *pid = 0; return 0; }
+inline onSsmlMarkReachedFuncType& offline_ssml_mark_callback() {
+    static onSsmlMarkReachedFuncType callback = nullptr;
+    return callback;
+}
+
+// Reports every <mark> at once (names as written, not unescaped). Like NVDA, only to a
+// synchronous call: the real callback runs inside the client's speakSsml RPC.
+inline error_status_t nvdaController_speakSsml(const wchar_t* ssml, const SYMBOL_LEVEL, const SPEECH_PRIORITY,
+                                               const boolean asynchronous) {
+    onSsmlMarkReachedFuncType callback = offline_ssml_mark_callback();
+    if (asynchronous || !callback) return 0;
+    static const wchar_t MARK_START[] = L"<mark name=\"";
+    for (const wchar_t* p = wcsstr(ssml, MARK_START); p; p = wcsstr(p, MARK_START)) {
+        p += wcslen(MARK_START);
+        const wchar_t* end = wcschr(p, L'"');
+        if (!end) break;
+        callback(std::wstring(p, end).c_str());
+        p = end;
+    }
+    return 0;
+}
+
+inline error_status_t nvdaController_setOnSsmlMarkReachedCallback(onSsmlMarkReachedFuncType callback) {
+    offline_ssml_mark_callback() = callback;
+    return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * Offline renderer for the NVDA-Arma 3 Bridge synth
+ *
+ * Runs a scripted timeline of bridge commands against the bridge compiled with
+ * BRIDGE_OFFLINE (no NVDA, no audio device) and writes the output to a WAV file
+ * (32-bit float stereo) or, for a .raw name, interleaved float32 without a header.
+ * The bridge clock follows the rendered samples, so a timeline renders the same
+ * output on every run. Commands are applied between device buffers, as they are
+ * in the game; the period sets that granularity.
+ *
+ * SIMD kernels differ from scalar in the last bits: set BRIDGE_SYNTH_ISA to
+ * scalar, sse2 or avx2 to compare renders made on different CPUs.
+ * Speech commands are accepted (NVDA is silent), but go through the speech worker
+ * thread, so speech ducking starts within a buffer or two of its timeline time.
+ * The output rate is 44100 Hz unless the 0 ms commands set another with
+ * audio_config:sample_rate (later rate changes are not supported here).
+ *
+ * Build on Linux:
+ *   ./build_render.sh
+ *
+ * Usage:
+ *   render_timeline timeline.txt out.wav [period_frames]
+ *
+ * Timeline: "<ms> <command>" per line; '#' at the start or after a space starts a
+ * comment (so surfaces like #GdtGrassGreen pass through). The command is the plain
+ * string form, or a name followed by an SQF array for the typed args form.
+ * "end" sets the length (default: 1 second after the last command).
+ *   0     radar_start
+ *   0     radar_sweep_start:1000,45
+ *   100   radar_sweep_hit [12, 0.3, 12.5, "grass"]
+ *   400   beacon_start
+ *   400   beacon_update [0.5, 150, 0]
+ *   1500  end
+ *
+ * Prints each reply, then the peak and RMS per channel and every sounding segment
+ * (5 ms windows within 40 dB of the peak): start/end time, peak per channel and the
+ * zero-crossing frequency, for checking envelope timing, pan and pitch.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+extern "C" {
+    void RVExtension(char *output, int outputSize, const char *function);
+    int RVExtensionArgs(char *output, int outputSize, const char *function, const char **args, int argsCnt);
+}
+void offline_render(float* output, int frameCount);
+int offline_sample_rate();
+
+static const float SEGMENT_RANGE = 0.01f;        // Segments: within 40 dB of the render's peak
+
+struct TimelineEvent {
+    double ms;
+    int line;
+    std::string command;                         // Plain form, or the name for typed args
+    std::vector<std::string> args;
+    bool typed;
+};
+
+static std::string trim(const std::string& str) {
+    size_t start = str.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) return std::string();
+    size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(start, end - start + 1);
+}
+
+// Split "[a, "b, c", [d, e]]" into its top-level elements, keeping quotes as Arma does
+static bool split_array(const std::string& text, std::vector<std::string>& elements) {
+    if (text.size() < 2 || text.front() != '[' || text.back() != ']') return false;
+    std::string current;
+    int depth = 0;
+    bool quoted = false;
+    for (size_t i = 1; i + 1 < text.size(); i++) {
+        char c = text[i];
+        if (c == '"') quoted = !quoted;
+        if (!quoted && c == '[') depth++;
+        if (!quoted && c == ']') depth--;
+        if (!quoted && depth == 0 && c == ',') {
+            elements.push_back(trim(current));
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!trim(current).empty() || !elements.empty()) elements.push_back(trim(current));
+    return depth == 0 && !quoted;
+}
+
+static bool load_timeline(const char* path, std::vector<TimelineEvent>& events, double& endMs) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("ERROR: could not open %s\n", path);
+        return false;
+    }
+
+    char buf[4096];
+    int line = 0;
+    bool ok = true;
+    while (fgets(buf, sizeof(buf), file)) {
+        line++;
+        std::string text = buf;
+        // A comment starts the line or follows whitespace ("#GdtGrassGreen" is a surface)
+        for (size_t i = 0; i < text.size(); i++) {
+            if (text[i] == '#' && (i == 0 || text[i - 1] == ' ' || text[i - 1] == '\t')) {
+                text.erase(i);
+                break;
+            }
+        }
+        text = trim(text);
+        if (text.empty()) continue;
+
+        char* rest = nullptr;
+        double ms = strtod(text.c_str(), &rest);
+        std::string command = trim(rest ? rest : "");
+        if (rest == text.c_str() || command.empty() || ms < 0.0) {
+            printf("ERROR: line %d: expected \"<ms> <command>\"\n", line);
+            ok = false;
+            continue;
+        }
+        if (command == "end") {
+            endMs = ms;
+            continue;
+        }
+
+        TimelineEvent event;
+        event.ms = ms;
+        event.line = line;
+        event.typed = false;
+        size_t bracket = command.find('[');
+        if (bracket != std::string::npos && command.find(':') > bracket) {
+            event.typed = true;
+            event.command = trim(command.substr(0, bracket));
+            if (!split_array(trim(command.substr(bracket)), event.args)) {
+                printf("ERROR: line %d: bad argument array\n", line);
+                ok = false;
+                continue;
+            }
+        } else {
+            event.command = command;
+        }
+        events.push_back(event);
+    }
+    fclose(file);
+
+    std::stable_sort(events.begin(), events.end(),
+                     [](const TimelineEvent& a, const TimelineEvent& b) { return a.ms < b.ms; });
+    if (endMs < 0.0) endMs = (events.empty() ? 0.0 : events.back().ms) + 1000.0;
+    return ok;
+}
+
+static void run_event(const TimelineEvent& event, double nowMs) {
+    static char output[10240];
+    if (event.typed) {
+        std::vector<const char*> args;
+        for (const std::string& arg : event.args) args.push_back(arg.c_str());
+        int code = RVExtensionArgs(output, sizeof(output), event.command.c_str(),
+                                   args.data(), (int)args.size());
+        printf("%9.2f ms  %s [%d args] -> %s (%d)\n", nowMs, event.command.c_str(), (int)args.size(), output, code);
+    } else {
+        RVExtension(output, sizeof(output), event.command.c_str());
+        printf("%9.2f ms  %s -> %s\n", nowMs, event.command.c_str(), output);
+    }
+}
+
+static void write_u32(FILE* file, unsigned int value) { fwrite(&value, 4, 1, file); }
+static void write_u16(FILE* file, unsigned short value) { fwrite(&value, 2, 1, file); }
+
+static bool write_output(const char* path, const std::vector<float>& audio, int sampleRate) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        printf("ERROR: could not write %s\n", path);
+        return false;
+    }
+
+    size_t length = strlen(path);
+    bool raw = length >= 4 && strcmp(path + length - 4, ".raw") == 0;
+    unsigned int dataBytes = (unsigned int)(audio.size() * sizeof(float));
+    if (!raw) {
+        // WAVE_FORMAT_IEEE_FLOAT, 2 channels
+        fwrite("RIFF", 1, 4, file);
+        write_u32(file, 36 + dataBytes);
+        fwrite("WAVEfmt ", 1, 8, file);
+        write_u32(file, 16);
+        write_u16(file, 3);
+        write_u16(file, 2);
+        write_u32(file, sampleRate);
+        write_u32(file, sampleRate * 2 * sizeof(float));
+        write_u16(file, 2 * sizeof(float));
+        write_u16(file, 32);
+        fwrite("data", 1, 4, file);
+        write_u32(file, dataBytes);
+    }
+    fwrite(audio.data(), 1, dataBytes, file);
+    fclose(file);
+    return true;
+}
+
+// Per-channel levels and the sounding segments
+static void print_summary(const std::vector<float>& audio, int sampleRate) {
+    const int SEGMENT_WINDOW = sampleRate / 200;
+    long long frames = (long long)audio.size() / 2;
+    float peak[2] = { 0.0f, 0.0f };
+    double sumSquares[2] = { 0.0, 0.0 };
+    for (long long i = 0; i < frames; i++) {
+        for (int c = 0; c < 2; c++) {
+            float v = audio[i * 2 + c];
+            peak[c] = std::max(peak[c], fabsf(v));
+            sumSquares[c] += (double)v * v;
+        }
+    }
+    for (int c = 0; c < 2; c++) {
+        double rms = frames ? sqrt(sumSquares[c] / frames) : 0.0;
+        printf("%s: peak %.4f (%.1f dBFS)  rms %.4f\n", c ? "right" : "left ", peak[c],
+               20.0 * log10(std::max(peak[c], 1e-9f)), rms);
+    }
+
+    float threshold = std::max(peak[0], peak[1]) * SEGMENT_RANGE;
+    printf("segments (start ms, end ms, peak L, peak R, zero-crossing Hz):\n");
+    long long segmentStart = -1;
+    float segmentPeak[2] = { 0.0f, 0.0f };
+    int crossings = 0;
+    float previous = 0.0f;
+    for (long long window = 0; window * SEGMENT_WINDOW <= frames; window++) {
+        long long start = window * SEGMENT_WINDOW;
+        long long end = std::min(start + SEGMENT_WINDOW, frames);
+        float windowPeak[2] = { 0.0f, 0.0f };
+        for (long long i = start; i < end; i++) {
+            windowPeak[0] = std::max(windowPeak[0], fabsf(audio[i * 2]));
+            windowPeak[1] = std::max(windowPeak[1], fabsf(audio[i * 2 + 1]));
+        }
+        bool sounding = threshold > 0.0f && std::max(windowPeak[0], windowPeak[1]) > threshold;
+
+        if (sounding) {
+            if (segmentStart < 0) {
+                segmentStart = start;
+                segmentPeak[0] = segmentPeak[1] = 0.0f;
+                crossings = 0;
+                previous = 0.0f;
+            }
+            for (long long i = start; i < end; i++) {
+                float mono = audio[i * 2] + audio[i * 2 + 1];
+                if ((previous < 0.0f && mono >= 0.0f) || (previous >= 0.0f && mono < 0.0f)) crossings++;
+                previous = mono;
+            }
+            segmentPeak[0] = std::max(segmentPeak[0], windowPeak[0]);
+            segmentPeak[1] = std::max(segmentPeak[1], windowPeak[1]);
+        }
+        if (segmentStart >= 0 && (!sounding || end == frames)) {
+            long long segmentEnd = sounding ? end : start;
+            double seconds = (double)(segmentEnd - segmentStart) / sampleRate;
+            printf("  %9.2f %9.2f  %.4f %.4f  %7.1f\n", segmentStart * 1000.0 / sampleRate,
+                   segmentEnd * 1000.0 / sampleRate, segmentPeak[0], segmentPeak[1],
+                   seconds > 0.0 ? crossings / 2.0 / seconds : 0.0);
+            segmentStart = -1;
+        }
+        if (end == frames) break;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("Usage: render_timeline timeline.txt out.wav|out.raw [period_frames]\n");
+        return 1;
+    }
+    int period = (argc > 3) ? atoi(argv[3]) : 512;
+    if (period <= 0) period = 512;
+
+    std::vector<TimelineEvent> events;
+    double endMs = -1.0;
+    if (!load_timeline(argv[1], events, endMs)) return 1;
+
+    // The 0 ms commands run first: they may set the output rate
+    size_t next = 0;
+    for (; next < events.size() && events[next].ms <= 0.0; next++) {
+        run_event(events[next], 0.0);
+    }
+    int sampleRate = offline_sample_rate();
+
+    long long totalFrames = (long long)(endMs * sampleRate / 1000.0 + 0.5);
+    std::vector<float> audio((size_t)totalFrames * 2);
+    for (long long frame = 0; frame < totalFrames; frame += period) {
+        double nowMs = frame * 1000.0 / sampleRate;
+        for (; next < events.size() && events[next].ms <= nowMs; next++) {
+            run_event(events[next], nowMs);
+        }
+        offline_render(&audio[(size_t)frame * 2], (int)std::min<long long>(period, totalFrames - frame));
+    }
+    for (; next < events.size(); next++) {
+        printf("line %d: after the end, not run\n", events[next].line);
+    }
+
+    static char stats[1024];
+    RVExtension(stats, sizeof(stats), "audio_stats");
+    printf("\n%lld frames (%.1f ms at %d Hz), period %d, %s\n", totalFrames, endMs, sampleRate, period, stats);
+    print_summary(audio, sampleRate);
+
+    if (!write_output(argv[2], audio, sampleRate)) return 1;
+    printf("wrote %s\n", argv[2]);
+    return 0;
+}
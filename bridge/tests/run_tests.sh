@@ -0,0 +1,65 @@
+#!/bin/sh
+# Golden-file tests for the offline synth (Linux, no NVDA or audio device)
+#
+# Builds render_timeline (see build_render.sh) and renders every tests/*.txt timeline
+# with the scalar kernels (BRIDGE_SYNTH_ISA=scalar), then compares what it prints -
+# replies, per-channel peak/RMS and the segment table (timing, level per ear, pitch) -
+# with tests/<name>.expected. Then runs spectral_test (radar aliasing below -30 dB).
+# Exits non-zero if any timeline differs or the spectral test fails.
+#
+# Usage:
+#   tests/run_tests.sh            run all timelines
+#   tests/run_tests.sh --update   rewrite the .expected files (after an intended change)
+
+cd "$(dirname "$0")" || exit 1
+
+UPDATE=0
+if [ "$1" = "--update" ]; then
+    UPDATE=1
+fi
+
+BUILD_DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+echo "Building render_timeline and spectral_test..."
+g++ -std=c++17 -O2 -DBRIDGE_OFFLINE -o "$BUILD_DIR/render_timeline" \
+    ../render_timeline.cpp ../nvda_arma3_bridge.cpp -lpthread || exit 1
+g++ -std=c++17 -O2 -DBRIDGE_OFFLINE -o "$BUILD_DIR/spectral_test" \
+    spectral_test.cpp ../nvda_arma3_bridge.cpp -lpthread || exit 1
+
+export BRIDGE_SYNTH_ISA=scalar
+FAILED=0
+for timeline in *.txt; do
+    name="${timeline%.txt}"
+    if ! "$BUILD_DIR/render_timeline" "$timeline" "$BUILD_DIR/$name.wav" > "$BUILD_DIR/$name.log"; then
+        cat "$BUILD_DIR/$name.log"
+        echo "FAIL    $name (render failed)"
+        FAILED=1
+        continue
+    fi
+    # The last line names the temporary WAV, which changes every run
+    grep -v '^wrote ' "$BUILD_DIR/$name.log" > "$BUILD_DIR/$name.out"
+
+    if [ $UPDATE -eq 1 ]; then
+        cp "$BUILD_DIR/$name.out" "$name.expected"
+        echo "UPDATED $name"
+    elif diff -u "$name.expected" "$BUILD_DIR/$name.out"; then
+        echo "PASS    $name"
+    else
+        echo "FAIL    $name"
+        FAILED=1
+    fi
+done
+
+echo
+if [ $UPDATE -eq 0 ] && ! "$BUILD_DIR/spectral_test"; then
+    FAILED=1
+fi
+
+if [ $FAILED -ne 0 ]; then
+    echo
+    echo "TESTS FAILED!"
+    exit 1
+fi
+echo
+echo "ALL TESTS PASSED"
@@ -0,0 +1,153 @@
+/*
+ * Radar aliasing test for the NVDA-Arma 3 Bridge synth (offline build)
+ *
+ * Renders a steady tone of every radar material through the bridge's RadarVoice
+ * (offline_radar_tone: the beep waveform without its 25 ms envelope, so the FFT can
+ * resolve aliases from the harmonics next to them) and measures the energy that does
+ * not sit on a harmonic of the material's partials. Aliases from the square, saw and
+ * pulse edges fold back between the harmonics; the test fails if that energy is above
+ * MAX_NON_HARMONIC_DB of the total.
+ *
+ * The rates must leave every edged material's aliases off its harmonics: at 48, 88.2
+ * and 96 kHz one of 400, 600 or 800 Hz divides the rate, so that row could not fail.
+ * 44.1 kHz (the default) and 66.15 kHz put the folded harmonics at least 100 Hz away
+ * from the nearest real one. (At 22.05 kHz the 800 Hz man pulse measures about -28 dB;
+ * the two-sample PolyBLEP runs out of room there.)
+ *
+ * Build and run on Linux (run_tests.sh does both):
+ *   g++ -std=c++17 -O2 -DBRIDGE_OFFLINE -o spectral_test spectral_test.cpp ../nvda_arma3_bridge.cpp -lpthread
+ *   BRIDGE_SYNTH_ISA=scalar ./spectral_test
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+extern "C" {
+    void RVExtension(char *output, int outputSize, const char *function);
+}
+int offline_sample_rate();
+void offline_radar_tone(int material, float* output, int frameCount);
+
+static const double MAX_NON_HARMONIC_DB = -30.0;
+static const int FFT_SIZE = 65536;             // ~0.7 Hz bins at 44.1 kHz
+static const double BAND_HZ = 10.0;            // Around each harmonic: window main lobe + margin
+static const double PI = 3.14159265358979323846;
+
+// Radar materials (RadarMaterial) with their RADAR_FREQ_* and partials (multiples of
+// the frequency; water adds an inharmonic partial at 2.3x on purpose)
+struct MaterialTone {
+    const char* name;
+    int material;
+    double freq;
+    double partials[2];
+    int partialCount;
+};
+static const MaterialTone MATERIALS[] = {
+    { "default",  0, 350.0, { 1.0 }, 1 },
+    { "grass",    1, 200.0, { 1.0 }, 1 },
+    { "concrete", 2, 400.0, { 1.0 }, 1 },
+    { "wood",     3, 300.0, { 1.0 }, 1 },
+    { "metal",    4, 600.0, { 1.0 }, 1 },
+    { "water",    5, 150.0, { 1.0, 2.3 }, 2 },
+    { "man",      6, 800.0, { 1.0 }, 1 },
+    { "glass",    7, 700.0, { 1.0 }, 1 },
+};
+static const int SAMPLE_RATES[] = { 44100, 66150 };  // See the header: no 400/600/800 Hz divisor
+
+// In-place radix-2 FFT (size a power of 2)
+static void fft(std::vector<std::complex<double>>& data) {
+    size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+    for (size_t length = 2; length <= n; length <<= 1) {
+        std::complex<double> step = std::polar(1.0, -2.0 * PI / (double)length);
+        for (size_t start = 0; start < n; start += length) {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < length / 2; k++) {
+                std::complex<double> even = data[start + k];
+                std::complex<double> odd = data[start + k + length / 2] * w;
+                data[start + k] = even + odd;
+                data[start + k + length / 2] = even - odd;
+                w *= step;
+            }
+        }
+    }
+}
+
+// Energy outside the harmonic bands relative to the total, in dB
+static double non_harmonic_db(const MaterialTone& tone, int sampleRate) {
+    std::vector<float> samples(FFT_SIZE);
+    offline_radar_tone(tone.material, samples.data(), FFT_SIZE);
+
+    // 4-term Blackman-Harris window: sidelobes below -92 dB, so leakage stays in the band
+    std::vector<std::complex<double>> spectrum(FFT_SIZE);
+    for (int i = 0; i < FFT_SIZE; i++) {
+        double x = 2.0 * PI * i / FFT_SIZE;
+        double window = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+        spectrum[i] = samples[i] * window;
+    }
+    fft(spectrum);
+
+    double binHz = (double)sampleRate / FFT_SIZE;
+    double total = 0.0;
+    double outside = 0.0;
+    for (int bin = 0; bin <= FFT_SIZE / 2; bin++) {
+        double energy = std::norm(spectrum[bin]);
+        double hz = bin * binHz;
+        bool harmonic = false;
+        for (int p = 0; p < tone.partialCount && !harmonic; p++) {
+            double partial = tone.freq * tone.partials[p];
+            double nearest = floor(hz / partial + 0.5) * partial;  // DC counts as harmonic 0
+            harmonic = fabs(hz - nearest) <= BAND_HZ;
+        }
+        total += energy;
+        if (!harmonic) outside += energy;
+    }
+    return 10.0 * log10((outside + 1e-30) / total);
+}
+
+int main() {
+    static char output[1024];
+    int failures = 0;
+    printf("non-harmonic energy per radar material (limit %.0f dB):\n", MAX_NON_HARMONIC_DB);
+    printf("  %-10s", "");
+    for (int rate : SAMPLE_RATES) printf(" %9d Hz", rate);
+    printf("\n");
+
+    std::vector<double> results[sizeof(SAMPLE_RATES) / sizeof(SAMPLE_RATES[0])];
+    for (size_t r = 0; r < sizeof(SAMPLE_RATES) / sizeof(SAMPLE_RATES[0]); r++) {
+        char command[64];
+        snprintf(command, sizeof(command), "audio_config:sample_rate,%d", SAMPLE_RATES[r]);
+        RVExtension(output, sizeof(output), command);
+        if (offline_sample_rate() != SAMPLE_RATES[r]) {
+            printf("ERROR: could not switch to %d Hz (%s)\n", SAMPLE_RATES[r], output);
+            return 1;
+        }
+        for (const MaterialTone& tone : MATERIALS) {
+            results[r].push_back(non_harmonic_db(tone, SAMPLE_RATES[r]));
+        }
+    }
+
+    for (size_t m = 0; m < sizeof(MATERIALS) / sizeof(MATERIALS[0]); m++) {
+        printf("  %-10s", MATERIALS[m].name);
+        for (size_t r = 0; r < sizeof(SAMPLE_RATES) / sizeof(SAMPLE_RATES[0]); r++) {
+            bool ok = results[r][m] <= MAX_NON_HARMONIC_DB;
+            if (!ok) failures++;
+            printf(" %9.1f dB%s", results[r][m], ok ? " " : "!");
+        }
+        printf("\n");
+    }
+
+    if (failures > 0) {
+        printf("\nFAILED: %d material/rate pairs above %.0f dB (marked !)\n", failures, MAX_NON_HARMONIC_DB);
+        return 1;
+    }
+    printf("\nPASSED\n");
+    return 0;
+}